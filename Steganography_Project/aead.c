@@ -0,0 +1,486 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - ChaCha20-Poly1305 authenticated encryption
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "aead.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define AEAD_X86 1
+#endif
+
+#define CHACHA_BLOCK 64
+#define POLY_BLOCK 16
+#define MASK44 0xFFFFFFFFFFFULL
+#define MASK42 0x3FFFFFFFFFFULL
+
+typedef struct
+{
+    uint64_t r[3];
+    uint64_t h[3];
+    uint64_t pad[2];
+} Poly1305;
+
+// XOR whole 64-byte blocks of keystream into data, advancing the counter in state[12]
+typedef void (*ChachaBlocksFn)(uint32_t state[16], unsigned char *data, size_t blocks);
+
+static ChachaBlocksFn chacha_blocks;
+
+static uint32_t load32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint64_t load64(const unsigned char *p)
+{
+    return (uint64_t)load32(p) | (uint64_t)load32(p + 4) << 32;
+}
+
+static void store64(unsigned char *p, uint64_t v)
+{
+    int i;
+
+    for (i = 0; i < 8; i++)
+        p[i] = v >> (8 * i);
+}
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTER(a, b, c, d)       \
+    do                            \
+    {                             \
+        a += b;                   \
+        d = ROTL32(d ^ a, 16);    \
+        c += d;                   \
+        b = ROTL32(b ^ c, 12);    \
+        a += b;                   \
+        d = ROTL32(d ^ a, 8);     \
+        c += d;                   \
+        b = ROTL32(b ^ c, 7);     \
+    } while (0)
+
+// Constants, key, counter and nonce as laid out by RFC 8439
+static void chacha_setup(uint32_t state[16], const unsigned char *key, const unsigned char *nonce, uint32_t counter)
+{
+    int i;
+
+    state[0] = 0x61707865;
+    state[1] = 0x3320646e;
+    state[2] = 0x79622d32;
+    state[3] = 0x6b206574;
+    for (i = 0; i < 8; i++)
+        state[4 + i] = load32(key + 4 * i);
+    state[12] = counter;
+    for (i = 0; i < 3; i++)
+        state[13 + i] = load32(nonce + 4 * i);
+}
+
+// One keystream block, counter advanced
+static void chacha_block(uint32_t state[16], unsigned char out[CHACHA_BLOCK])
+{
+    uint32_t x[16];
+    int i;
+
+    memcpy(x, state, sizeof(x));
+    for (i = 0; i < 10; i++)
+    {
+        QUARTER(x[0], x[4], x[8], x[12]);
+        QUARTER(x[1], x[5], x[9], x[13]);
+        QUARTER(x[2], x[6], x[10], x[14]);
+        QUARTER(x[3], x[7], x[11], x[15]);
+        QUARTER(x[0], x[5], x[10], x[15]);
+        QUARTER(x[1], x[6], x[11], x[12]);
+        QUARTER(x[2], x[7], x[8], x[13]);
+        QUARTER(x[3], x[4], x[9], x[14]);
+    }
+    for (i = 0; i < 16; i++)
+    {
+        uint32_t v = x[i] + state[i];
+
+        out[4 * i] = v;
+        out[4 * i + 1] = v >> 8;
+        out[4 * i + 2] = v >> 16;
+        out[4 * i + 3] = v >> 24;
+    }
+    state[12]++;
+}
+
+static void chacha_blocks_scalar(uint32_t state[16], unsigned char *data, size_t blocks)
+{
+    unsigned char stream[CHACHA_BLOCK];
+    int i;
+
+    for (; blocks > 0; blocks--, data += CHACHA_BLOCK)
+    {
+        chacha_block(state, stream);
+        for (i = 0; i < CHACHA_BLOCK; i++)
+            data[i] ^= stream[i];
+    }
+}
+
+#ifdef AEAD_X86
+// SSE2: four blocks side by side, lane j of x[i] is word i of block j
+#define ROTL_SSE2(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+#define QUARTER_SSE2(a, b, c, d)                  \
+    do                                            \
+    {                                             \
+        a = _mm_add_epi32(a, b);                  \
+        d = ROTL_SSE2(_mm_xor_si128(d, a), 16);   \
+        c = _mm_add_epi32(c, d);                  \
+        b = ROTL_SSE2(_mm_xor_si128(b, c), 12);   \
+        a = _mm_add_epi32(a, b);                  \
+        d = ROTL_SSE2(_mm_xor_si128(d, a), 8);    \
+        c = _mm_add_epi32(c, d);                  \
+        b = ROTL_SSE2(_mm_xor_si128(b, c), 7);    \
+    } while (0)
+
+// Words w..w+3 of the four blocks back into block order, XORed into data
+#define XOR4_SSE2(data, x, w)                                                       \
+    do                                                                              \
+    {                                                                               \
+        __m128i t0 = _mm_unpacklo_epi32(x[w], x[w + 1]);                            \
+        __m128i t1 = _mm_unpackhi_epi32(x[w], x[w + 1]);                            \
+        __m128i t2 = _mm_unpacklo_epi32(x[w + 2], x[w + 3]);                        \
+        __m128i t3 = _mm_unpackhi_epi32(x[w + 2], x[w + 3]);                        \
+        __m128i *o0 = (__m128i *)(data + 4 * (w));                                  \
+        __m128i *o1 = (__m128i *)(data + CHACHA_BLOCK + 4 * (w));                   \
+        __m128i *o2 = (__m128i *)(data + 2 * CHACHA_BLOCK + 4 * (w));               \
+        __m128i *o3 = (__m128i *)(data + 3 * CHACHA_BLOCK + 4 * (w));               \
+        _mm_storeu_si128(o0, _mm_xor_si128(_mm_loadu_si128(o0), _mm_unpacklo_epi64(t0, t2))); \
+        _mm_storeu_si128(o1, _mm_xor_si128(_mm_loadu_si128(o1), _mm_unpackhi_epi64(t0, t2))); \
+        _mm_storeu_si128(o2, _mm_xor_si128(_mm_loadu_si128(o2), _mm_unpacklo_epi64(t1, t3))); \
+        _mm_storeu_si128(o3, _mm_xor_si128(_mm_loadu_si128(o3), _mm_unpackhi_epi64(t1, t3))); \
+    } while (0)
+
+__attribute__((target("sse2"))) static void chacha_blocks_sse2(uint32_t state[16], unsigned char *data, size_t blocks)
+{
+    __m128i x[16], s[16];
+    int i;
+
+    for (; blocks >= 4; blocks -= 4, data += 4 * CHACHA_BLOCK)
+    {
+        for (i = 0; i < 16; i++)
+            s[i] = _mm_set1_epi32(state[i]);
+        s[12] = _mm_add_epi32(s[12], _mm_set_epi32(3, 2, 1, 0));
+        memcpy(x, s, sizeof(x));
+
+        for (i = 0; i < 10; i++)
+        {
+            QUARTER_SSE2(x[0], x[4], x[8], x[12]);
+            QUARTER_SSE2(x[1], x[5], x[9], x[13]);
+            QUARTER_SSE2(x[2], x[6], x[10], x[14]);
+            QUARTER_SSE2(x[3], x[7], x[11], x[15]);
+            QUARTER_SSE2(x[0], x[5], x[10], x[15]);
+            QUARTER_SSE2(x[1], x[6], x[11], x[12]);
+            QUARTER_SSE2(x[2], x[7], x[8], x[13]);
+            QUARTER_SSE2(x[3], x[4], x[9], x[14]);
+        }
+        for (i = 0; i < 16; i++)
+            x[i] = _mm_add_epi32(x[i], s[i]);
+
+        XOR4_SSE2(data, x, 0);
+        XOR4_SSE2(data, x, 4);
+        XOR4_SSE2(data, x, 8);
+        XOR4_SSE2(data, x, 12);
+        state[12] += 4;
+    }
+    chacha_blocks_scalar(state, data, blocks);
+}
+
+// AVX2: eight blocks side by side, 16- and 8-bit rotations as byte shuffles
+#define ROTL_AVX2(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+
+#define QUARTER_AVX2(a, b, c, d)                                  \
+    do                                                            \
+    {                                                             \
+        a = _mm256_add_epi32(a, b);                               \
+        d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot16);   \
+        c = _mm256_add_epi32(c, d);                               \
+        b = ROTL_AVX2(_mm256_xor_si256(b, c), 12);                \
+        a = _mm256_add_epi32(a, b);                               \
+        d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot8);    \
+        c = _mm256_add_epi32(c, d);                               \
+        b = ROTL_AVX2(_mm256_xor_si256(b, c), 7);                 \
+    } while (0)
+
+// 4x4 transpose inside each 128-bit half: y[w + j] = words w..w+3 of blocks j (low) and j + 4 (high)
+#define TRANSPOSE4_AVX2(x, y, w)                                  \
+    do                                                            \
+    {                                                             \
+        __m256i t0 = _mm256_unpacklo_epi32(x[w], x[w + 1]);       \
+        __m256i t1 = _mm256_unpackhi_epi32(x[w], x[w + 1]);       \
+        __m256i t2 = _mm256_unpacklo_epi32(x[w + 2], x[w + 3]);   \
+        __m256i t3 = _mm256_unpackhi_epi32(x[w + 2], x[w + 3]);   \
+        y[w] = _mm256_unpacklo_epi64(t0, t2);                     \
+        y[w + 1] = _mm256_unpackhi_epi64(t0, t2);                 \
+        y[w + 2] = _mm256_unpacklo_epi64(t1, t3);                 \
+        y[w + 3] = _mm256_unpackhi_epi64(t1, t3);                 \
+    } while (0)
+
+__attribute__((target("avx2"))) static void xor32_avx2(unsigned char *data, __m256i stream)
+{
+    __m256i *p = (__m256i *)data;
+
+    _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), stream));
+}
+
+__attribute__((target("avx2"))) static void chacha_blocks_avx2(uint32_t state[16], unsigned char *data, size_t blocks)
+{
+    const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                           2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m256i rot8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                          3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    __m256i x[16], s[16], y[16];
+    int i, j;
+
+    for (; blocks >= 8; blocks -= 8, data += 8 * CHACHA_BLOCK)
+    {
+        for (i = 0; i < 16; i++)
+            s[i] = _mm256_set1_epi32(state[i]);
+        s[12] = _mm256_add_epi32(s[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        memcpy(x, s, sizeof(x));
+
+        for (i = 0; i < 10; i++)
+        {
+            QUARTER_AVX2(x[0], x[4], x[8], x[12]);
+            QUARTER_AVX2(x[1], x[5], x[9], x[13]);
+            QUARTER_AVX2(x[2], x[6], x[10], x[14]);
+            QUARTER_AVX2(x[3], x[7], x[11], x[15]);
+            QUARTER_AVX2(x[0], x[5], x[10], x[15]);
+            QUARTER_AVX2(x[1], x[6], x[11], x[12]);
+            QUARTER_AVX2(x[2], x[7], x[8], x[13]);
+            QUARTER_AVX2(x[3], x[4], x[9], x[14]);
+        }
+        for (i = 0; i < 16; i++)
+            x[i] = _mm256_add_epi32(x[i], s[i]);
+
+        TRANSPOSE4_AVX2(x, y, 0);
+        TRANSPOSE4_AVX2(x, y, 4);
+        TRANSPOSE4_AVX2(x, y, 8);
+        TRANSPOSE4_AVX2(x, y, 12);
+
+        // Block j takes the low halves of y[j], y[4 + j], ..., block j + 4 the high halves
+        for (j = 0; j < 4; j++)
+        {
+            unsigned char *lo = data + j * CHACHA_BLOCK;
+            unsigned char *hi = data + (j + 4) * CHACHA_BLOCK;
+
+            xor32_avx2(lo, _mm256_permute2x128_si256(y[j], y[4 + j], 0x20));
+            xor32_avx2(lo + 32, _mm256_permute2x128_si256(y[8 + j], y[12 + j], 0x20));
+            xor32_avx2(hi, _mm256_permute2x128_si256(y[j], y[4 + j], 0x31));
+            xor32_avx2(hi + 32, _mm256_permute2x128_si256(y[8 + j], y[12 + j], 0x31));
+        }
+        state[12] += 8;
+    }
+    chacha_blocks_sse2(state, data, blocks);
+}
+#endif
+
+void chacha20_xor(const unsigned char key[AEAD_KEY_SIZE], const unsigned char nonce[AEAD_NONCE_SIZE],
+                  uint32_t counter, unsigned char *data, size_t size)
+{
+    uint32_t state[16];
+    unsigned char stream[CHACHA_BLOCK];
+    size_t i, whole = size / CHACHA_BLOCK;
+
+    chacha_setup(state, key, nonce, counter);
+    chacha_blocks(state, data, whole);
+
+    // Partial last block
+    data += whole * CHACHA_BLOCK;
+    size -= whole * CHACHA_BLOCK;
+    if (size > 0)
+    {
+        chacha_block(state, stream);
+        for (i = 0; i < size; i++)
+            data[i] ^= stream[i];
+    }
+}
+
+// Key clamping as in poly1305-donna, 44/44/42-bit limbs
+static void poly_init(Poly1305 *st, const unsigned char key[32])
+{
+    uint64_t t0 = load64(key), t1 = load64(key + 8);
+
+    st->r[0] = t0 & 0xFFC0FFFFFFFULL;
+    st->r[1] = ((t0 >> 44) | (t1 << 20)) & 0xFFFFFC0FFFFULL;
+    st->r[2] = (t1 >> 24) & 0x00FFFFFFC0FULL;
+    st->h[0] = st->h[1] = st->h[2] = 0;
+    st->pad[0] = load64(key + 16);
+    st->pad[1] = load64(key + 24);
+}
+
+// h = (h + m) * r for every whole 16-byte block
+static void poly_blocks(Poly1305 *st, const unsigned char *m, size_t blocks)
+{
+    uint64_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2];
+    uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+    uint64_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2];
+    unsigned __int128 d0, d1, d2;
+    uint64_t t0, t1, c;
+
+    for (; blocks > 0; blocks--, m += POLY_BLOCK)
+    {
+        t0 = load64(m);
+        t1 = load64(m + 8);
+        h0 += t0 & MASK44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & MASK44;
+        h2 += ((t1 >> 24) & MASK42) | (1ULL << 40);
+
+        d0 = (unsigned __int128)h0 * r0 + (unsigned __int128)h1 * s2 + (unsigned __int128)h2 * s1;
+        d1 = (unsigned __int128)h0 * r1 + (unsigned __int128)h1 * r0 + (unsigned __int128)h2 * s2;
+        d2 = (unsigned __int128)h0 * r2 + (unsigned __int128)h1 * r1 + (unsigned __int128)h2 * r0;
+
+        c = (uint64_t)(d0 >> 44);
+        h0 = (uint64_t)d0 & MASK44;
+        d1 += c;
+        c = (uint64_t)(d1 >> 44);
+        h1 = (uint64_t)d1 & MASK44;
+        d2 += c;
+        c = (uint64_t)(d2 >> 42);
+        h2 = (uint64_t)d2 & MASK42;
+        h0 += c * 5;
+        c = h0 >> 44;
+        h0 &= MASK44;
+        h1 += c;
+    }
+    st->h[0] = h0;
+    st->h[1] = h1;
+    st->h[2] = h2;
+}
+
+// Data zero-padded to a multiple of 16 bytes, as the AEAD construction feeds it
+static void poly_padded(Poly1305 *st, const unsigned char *m, size_t size)
+{
+    unsigned char last[POLY_BLOCK] = {0};
+
+    poly_blocks(st, m, size / POLY_BLOCK);
+    if (size % POLY_BLOCK)
+    {
+        memcpy(last, m + size - size % POLY_BLOCK, size % POLY_BLOCK);
+        poly_blocks(st, last, 1);
+    }
+}
+
+// Fully reduce h, add the pad, write the tag
+static void poly_finish(Poly1305 *st, unsigned char tag[AEAD_TAG_SIZE])
+{
+    uint64_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2];
+    uint64_t g0, g1, g2, c, t0, t1;
+
+    c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= MASK42;
+    h0 += c * 5;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += c;
+    c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += c;
+    c = h2 >> 42;
+    h2 &= MASK42;
+    h0 += c * 5;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += c;
+
+    // h - p, kept only when h >= p (no borrow)
+    g0 = h0 + 5;
+    c = g0 >> 44;
+    g0 &= MASK44;
+    g1 = h1 + c;
+    c = g1 >> 44;
+    g1 &= MASK44;
+    g2 = h2 + c - (1ULL << 42);
+    c = (g2 >> 63) - 1;
+    h0 = (h0 & ~c) | (g0 & c);
+    h1 = (h1 & ~c) | (g1 & c);
+    h2 = (h2 & ~c) | (g2 & c);
+
+    t0 = st->pad[0];
+    t1 = st->pad[1];
+    h0 += t0 & MASK44;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & MASK44) + c;
+    c = h1 >> 44;
+    h1 &= MASK44;
+    h2 += ((t1 >> 24) & MASK42) + c;
+    h2 &= MASK42;
+
+    store64(tag, h0 | (h1 << 44));
+    store64(tag + 8, (h1 >> 20) | (h2 << 24));
+}
+
+// Poly1305 over aad and ciphertext with the one-time key from block 0
+static void aead_tag(const unsigned char *key, const unsigned char *nonce, const unsigned char *aad, size_t aad_size,
+                     const unsigned char *data, size_t size, unsigned char tag[AEAD_TAG_SIZE])
+{
+    uint32_t state[16];
+    unsigned char block[CHACHA_BLOCK];
+    unsigned char lengths[POLY_BLOCK];
+    Poly1305 st;
+
+    chacha_setup(state, key, nonce, 0);
+    chacha_block(state, block);
+    poly_init(&st, block);
+
+    poly_padded(&st, aad, aad_size);
+    poly_padded(&st, data, size);
+    store64(lengths, aad_size);
+    store64(lengths + 8, size);
+    poly_blocks(&st, lengths, 1);
+    poly_finish(&st, tag);
+    memset(block, 0, sizeof(block));
+}
+
+void aead_seal(const unsigned char key[AEAD_KEY_SIZE], const unsigned char nonce[AEAD_NONCE_SIZE],
+               const unsigned char *aad, size_t aad_size, unsigned char *data, size_t size,
+               unsigned char tag[AEAD_TAG_SIZE])
+{
+    chacha20_xor(key, nonce, 1, data, size);
+    aead_tag(key, nonce, aad, aad_size, data, size, tag);
+}
+
+Status aead_open(const unsigned char key[AEAD_KEY_SIZE], const unsigned char nonce[AEAD_NONCE_SIZE],
+                 const unsigned char *aad, size_t aad_size, unsigned char *data, size_t size,
+                 const unsigned char tag[AEAD_TAG_SIZE])
+{
+    unsigned char expect[AEAD_TAG_SIZE];
+    unsigned char diff = 0;
+    int i;
+
+    // Constant-time compare: how far the tags agree must not leak
+    aead_tag(key, nonce, aad, aad_size, data, size, expect);
+    for (i = 0; i < AEAD_TAG_SIZE; i++)
+        diff |= expect[i] ^ tag[i];
+    if (diff != 0)
+        return e_failure;
+
+    chacha20_xor(key, nonce, 1, data, size);
+    return e_success;
+}
+
+// Widest ChaCha20 core this CPU runs, the one block core under STEGO_KERNEL=scalar
+__attribute__((constructor)) static void aead_init(void)
+{
+    const char *name = getenv("STEGO_KERNEL");
+
+    chacha_blocks = chacha_blocks_scalar;
+    if (name != NULL && strcmp(name, "scalar") == 0)
+        return;
+#ifdef AEAD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        chacha_blocks = chacha_blocks_avx2;
+    else if (__builtin_cpu_supports("sse2"))
+        chacha_blocks = chacha_blocks_sse2;
+#endif
+}
@@ -0,0 +1,33 @@
+#ifndef AEAD_H
+#define AEAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "types.h" // Contains user defined types
+
+/*
+ * ChaCha20-Poly1305 (RFC 8439), in place on one buffer at a time.
+ * The ChaCha20 core runs 8 blocks at a time with AVX2 or 4 with SSE2
+ * when the CPU has them, one block at a time otherwise or under
+ * STEGO_KERNEL=scalar.
+ */
+
+#define AEAD_KEY_SIZE 32
+#define AEAD_NONCE_SIZE 12
+#define AEAD_TAG_SIZE 16
+
+/* Encrypt size bytes of data in place and write their tag; aad is only authenticated */
+void aead_seal(const unsigned char key[AEAD_KEY_SIZE], const unsigned char nonce[AEAD_NONCE_SIZE],
+               const unsigned char *aad, size_t aad_size, unsigned char *data, size_t size,
+               unsigned char tag[AEAD_TAG_SIZE]);
+
+/* Check the tag, then decrypt in place; e_failure (data untouched) when it does not match */
+Status aead_open(const unsigned char key[AEAD_KEY_SIZE], const unsigned char nonce[AEAD_NONCE_SIZE],
+                 const unsigned char *aad, size_t aad_size, unsigned char *data, size_t size,
+                 const unsigned char tag[AEAD_TAG_SIZE]);
+
+/* XOR data with the ChaCha20 keystream starting at block counter */
+void chacha20_xor(const unsigned char key[AEAD_KEY_SIZE], const unsigned char nonce[AEAD_NONCE_SIZE],
+                  uint32_t counter, unsigned char *data, size_t size);
+
+#endif
@@ -0,0 +1,104 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - header-only capacity analyzer
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "analyze.h"
+#include "stego.h"
+#include "types.h"
+
+// Write s as a JSON string literal
+void json_print_string(const char *s)
+{
+    putchar('"');
+    for (; *s != '\0'; s++)
+    {
+        if (*s == '"' || *s == '\\')
+            printf("\\%c", *s);
+        else if ((unsigned char)*s < 0x20)
+            printf("\\u%04x", (unsigned char)*s);
+        else
+            putchar(*s);
+    }
+    putchar('"');
+}
+
+// Report one cover, returns e_failure when it cannot be used
+static Status analyze_one(const char *path, int json, int first)
+{
+    StegoCoverInfo info;
+    StegoError err = stego_analyze_file(path, &info);
+
+    if (json)
+    {
+        printf("%s\n  {\"file\": ", first ? "" : ",");
+        json_print_string(path);
+        if (err != e_stego_ok)
+        {
+            printf(", \"error\": ");
+            json_print_string(stego_strerror(err));
+        }
+        else
+        {
+            printf(", \"width\": %ld, \"height\": %ld, \"bpp\": %d, \"top_down\": %s, \"data_offset\": %ld, "
+                   "\"usable\": %ld, \"max_payload\": {\"1\": %ld, \"2\": %ld, \"4\": %ld}",
+                   info.width, info.height, info.bpp, info.top_down ? "true" : "false", info.data_offset,
+                   info.usable, info.max_payload[0], info.max_payload[1], info.max_payload[2]);
+        }
+        putchar('}');
+    }
+    else if (err != e_stego_ok)
+    {
+        fflush(stdout);
+        fprintf(stderr, "❌ %s: %s\n", path, stego_strerror(err));
+    }
+    else
+    {
+        printf("📐 %s: %ldx%ld, %d bpp, %s, pixels at %ld\n", path, info.width, info.height, info.bpp,
+               info.top_down ? "top-down" : "bottom-up", info.data_offset);
+        printf("    usable %ld bytes, max payload %ld / %ld / %ld bytes at 1 / 2 / 4 bits\n", info.usable,
+               info.max_payload[0], info.max_payload[1], info.max_payload[2]);
+    }
+    return err == e_stego_ok ? e_success : e_failure;
+}
+
+Status run_analyze(char *paths[], int count, int json)
+{
+    Status status = e_success;
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t len;
+    int i, n = 0;
+
+    if (json)
+        putchar('[');
+
+    for (i = 0; i < count; i++)
+    {
+        if (analyze_one(paths[i], json, n++ == 0) == e_failure)
+            status = e_failure;
+    }
+
+    // No paths given: one per line on stdin, for callers with too many for argv
+    if (count == 0)
+    {
+        while ((len = getline(&line, &cap, stdin)) > 0)
+        {
+            if (line[len - 1] == '\n')
+                line[--len] = '\0';
+            if (len == 0)
+                continue;
+            if (analyze_one(line, json, n++ == 0) == e_failure)
+                status = e_failure;
+        }
+        free(line);
+    }
+
+    if (json)
+        printf("%s]\n", n ? "\n" : "");
+    return status;
+}
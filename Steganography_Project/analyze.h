@@ -0,0 +1,20 @@
+#ifndef ANALYZE_H
+#define ANALYZE_H
+
+#include "types.h" // Contains user defined types
+
+/*
+ * Capacity analyzer
+ * Reports what each cover offers from its BMP headers alone: nothing is
+ * created and the pixel array is never read, so thousands of candidate
+ * covers can be checked in a few milliseconds.
+ */
+
+/* Analyze count covers (paths on stdin, one per line, when count is 0) as text or JSON;
+ * e_failure if any of them is not usable */
+Status run_analyze(char *paths[], int count, int json);
+
+/* Write s on stdout as a JSON string literal, quotes included */
+void json_print_string(const char *s);
+
+#endif
@@ -0,0 +1,463 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - multi-file archives with a table of contents
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "archive.h"
+#include "crc32c.h"
+#include "parallel.h"
+#include "stego_log.h"
+#include "common.h"
+#include "bmp.h"
+
+static void put_word(unsigned char *p, uint32_t value)
+{
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+}
+
+static uint32_t get_word(const unsigned char *p)
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+// Bytes of the table of contents, its entry count included
+static long toc_size(const Archive *archive)
+{
+    long size = 4;
+    int i;
+
+    for (i = 0; i < archive->count; i++)
+        size += ARCHIVE_ENTRY_SIZE(strlen(archive->entries[i].name));
+    return size;
+}
+
+Status archive_prepare(EncodeInfo *encInfo, Archive *archive, char *const paths[], int count)
+{
+    StegoEntry *entry;
+    struct stat st;
+    const char *name;
+    long offset = 0;
+    int i, j;
+
+    memset(archive, 0, sizeof(*archive));
+    archive->entries = calloc(count, sizeof(StegoEntry));
+    if (archive->entries == NULL)
+    {
+        encInfo->error = e_stego_no_memory;
+        return e_failure;
+    }
+    archive->paths = paths;
+    archive->count = count;
+    encInfo->archive = archive;
+    encInfo->error = e_stego_bad_args;
+
+    // Offsets are known from the sizes alone: the table can go after the data
+    for (i = 0; i < count; i++)
+    {
+        entry = &archive->entries[i];
+        name = strrchr(paths[i], '/');
+        name = name != NULL ? name + 1 : paths[i];
+        if (stat(paths[i], &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            encInfo->error = e_stego_io;
+            stego_error("ERROR:❌ %s is not a readable file\n", paths[i]);
+            return e_failure;
+        }
+        if (*name == '\0' || strlen(name) > STEGO_MAX_NAME)
+        {
+            stego_error("ERROR:❌ %s: archived names are 1 to %d characters\n", paths[i], STEGO_MAX_NAME);
+            return e_failure;
+        }
+        for (j = 0; j < i; j++)
+        {
+            if (strcmp(archive->entries[j].name, name) == 0)
+            {
+                stego_error("ERROR:❌ %s and %s would both be archived as %s\n", paths[j], paths[i], name);
+                return e_failure;
+            }
+        }
+        strcpy(entry->name, name);
+        entry->offset = offset;
+        entry->size = st.st_size;
+        offset += st.st_size;
+    }
+    archive->toc_offset = offset;
+
+    // The size field is a signed 32-bit word
+    encInfo->size_secret_file = offset + toc_size(archive) + ARCHIVE_TRAILER_SIZE;
+    if (encInfo->size_secret_file > INT_MAX)
+    {
+        encInfo->error = e_stego_no_capacity;
+        stego_error("ERROR:❌ Archive of %ld bytes is beyond the 2 GB the size field holds\n", encInfo->size_secret_file);
+        return e_failure;
+    }
+    stego_info("📦 Archiving %d file(s), %ld bytes with the table of contents\n", count, encInfo->size_secret_file);
+    return e_success;
+}
+
+// Embed the table of contents and the trailer pointing at it
+static Status encode_toc(EncodeInfo *encInfo, const Archive *archive)
+{
+    long size = toc_size(archive);
+    unsigned char *toc = malloc(size + ARCHIVE_TRAILER_SIZE);
+    unsigned char *p = toc;
+    size_t length;
+    Status ret;
+    int i;
+
+    if (toc == NULL)
+        return e_failure;
+    put_word(p, archive->count);
+    p += 4;
+    for (i = 0; i < archive->count; i++)
+    {
+        length = strlen(archive->entries[i].name);
+        *p++ = length;
+        memcpy(p, archive->entries[i].name, length);
+        p += length;
+        put_word(p, archive->entries[i].offset);
+        put_word(p + 4, archive->entries[i].size);
+        put_word(p + 8, archive->entries[i].crc);
+        p += 12;
+    }
+    put_word(p, archive->toc_offset);
+    put_word(p + 4, crc32c_update(0, toc, size));
+
+    ret = encode_data_to_image((char *)toc, size + ARCHIVE_TRAILER_SIZE, &encInfo->engine);
+    free(toc);
+    return ret;
+}
+
+// Embed every file a block at a time, checksumming each on the way, then the table
+Status encode_archive_data(EncodeInfo *encInfo)
+{
+    Archive *archive = encInfo->archive;
+    char *buffer = malloc(LSB_PAYLOAD_BLOCK);
+    StegoEntry *entry;
+    FILE *fptr;
+    long done, chunk;
+    Status ret = e_success;
+    int i;
+
+    if (buffer == NULL)
+    {
+        stego_error("ERROR:❌ Unable to allocate buffer while encoding the archive\n");
+        return e_failure;
+    }
+
+    for (i = 0; i < archive->count && ret == e_success; i++)
+    {
+        entry = &archive->entries[i];
+        fptr = fopen(archive->paths[i], "r");
+        if (fptr == NULL)
+        {
+            stego_error("ERROR:❌ Unable to open file %s: %s\n", archive->paths[i], strerror(errno));
+            ret = e_failure;
+            break;
+        }
+        stego_info("📦 Adding %s (%ld bytes)\n", entry->name, entry->size);
+
+        entry->crc = 0;
+        for (done = 0; done < entry->size; done += chunk)
+        {
+            chunk = entry->size - done;
+            if (chunk > LSB_PAYLOAD_BLOCK)
+                chunk = LSB_PAYLOAD_BLOCK;
+
+            // The table already promised entry->size bytes: a file that shrank cannot be stored
+            if (fread(buffer, 1, chunk, fptr) != (size_t)chunk)
+            {
+                stego_error("ERROR:❌ %s changed while it was being archived\n", archive->paths[i]);
+                ret = e_failure;
+                break;
+            }
+            entry->crc = crc32c_update(entry->crc, buffer, chunk);
+            if (encode_data_to_image(buffer, chunk, &encInfo->engine) == e_failure)
+            {
+                ret = e_failure;
+                break;
+            }
+        }
+        fclose(fptr);
+    }
+
+    free(buffer);
+    if (ret == e_failure)
+        return e_failure;
+    return encode_toc(encInfo, archive);
+}
+
+// Stand at data byte offset of the archive
+static Status seek_data(DecodeInfo *decInfo, const Archive *archive, long offset)
+{
+    return lsb_engine_seek(&decInfo->engine, archive->data_start + LSB_CARRIER_SIZE(offset, decInfo->bits));
+}
+
+// Open the image and decode the fields in front of the data, as decode_image() does
+static Status open_archive(DecodeInfo *decInfo, Archive *archive)
+{
+    BmpLayout layout;
+
+    decInfo->fptr_stego_image = fopen(decInfo->stego_image_fname, "r");
+    if (decInfo->fptr_stego_image == NULL)
+    {
+        decInfo->error = e_stego_io;
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", decInfo->stego_image_fname, strerror(errno));
+        return e_failure;
+    }
+    if (bmp_read_layout(decInfo->fptr_stego_image, &layout, 1) == e_failure)
+    {
+        decInfo->error = e_stego_bad_image;
+        stego_error("ERROR:❌ %s is not an uncompressed 24 or 32 bpp BMP\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+    if (lsb_engine_init(&decInfo->engine, decInfo->fptr_stego_image, NULL, &layout) == e_failure)
+    {
+        decInfo->error = e_stego_no_memory;
+        stego_error("❌ Unable to allocate decoding buffer\n");
+        return e_failure;
+    }
+
+    // Entries are visited out of order: no read-ahead past the pages a seek lands on
+    if (decInfo->engine.map != NULL)
+        madvise((void *)decInfo->engine.map, decInfo->engine.map_size, MADV_RANDOM);
+
+    stage_enter(&decInfo->clock, e_stage_magic);
+    if (decode_magic_string(decInfo) == e_failure)
+    {
+        decInfo->error = e_stego_not_stego;
+        stego_error("❌ Magic string is not present\n");
+        return e_failure;
+    }
+    stage_enter(&decInfo->clock, e_stage_extn_size);
+    if (decode_secret_file_extn_size(decInfo) == e_failure)
+    {
+        decInfo->error = e_stego_corrupt;
+        return e_failure;
+    }
+    if (!decInfo->archive)
+    {
+        decInfo->error = e_stego_not_archive;
+        stego_error("❌ %s holds a single file, not an archive: decode it with -d\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+
+    decInfo->error = e_stego_io;
+    stage_enter(&decInfo->clock, e_stage_extn);
+    if (decode_secret_file_extn(decInfo) == e_failure)
+        return e_failure;
+    stage_enter(&decInfo->clock, e_stage_size);
+    if (decode_secret_file_size(decInfo) == e_failure || lsb_engine_set_bits(&decInfo->engine, decInfo->bits) == e_failure)
+        return e_failure;
+    archive->data_start = lsb_engine_tell(&decInfo->engine);
+    return e_success;
+}
+
+// Check and unpack the table of contents
+static Status parse_toc(DecodeInfo *decInfo, Archive *archive, const unsigned char *toc, long size)
+{
+    const unsigned char *p = toc + 4, *end = toc + size;
+    StegoEntry *entry;
+    long count = get_word(toc);
+    int i, length;
+
+    // Every entry takes at least ARCHIVE_ENTRY_SIZE(1) bytes: a count beyond that is garbage
+    if (count > (size - 4) / ARCHIVE_ENTRY_SIZE(1))
+        return e_failure;
+    archive->entries = calloc(count ? count : 1, sizeof(StegoEntry));
+    if (archive->entries == NULL)
+    {
+        decInfo->error = e_stego_no_memory;
+        return e_failure;
+    }
+    archive->count = count;
+
+    for (i = 0; i < count; i++)
+    {
+        entry = &archive->entries[i];
+        length = *p++;
+        if (length == 0 || end - p < length + 12)
+            return e_failure;
+        memcpy(entry->name, p, length);
+        entry->name[length] = '\0';
+        p += length;
+        entry->offset = get_word(p);
+        entry->size = get_word(p + 4);
+        entry->crc = get_word(p + 8);
+        p += 12;
+
+        // Names become output files: nothing that leaves the current directory
+        if (strlen(entry->name) != (size_t)length || strchr(entry->name, '/') != NULL ||
+            strcmp(entry->name, ".") == 0 || strcmp(entry->name, "..") == 0 ||
+            entry->offset + entry->size > archive->toc_offset)
+            return e_failure;
+    }
+    return p == end ? e_success : e_failure;
+}
+
+Status archive_read_toc(DecodeInfo *decInfo, Archive *archive)
+{
+    unsigned char trailer[ARCHIVE_TRAILER_SIZE];
+    unsigned char *toc;
+    long size;
+    Status ret;
+
+    memset(archive, 0, sizeof(*archive));
+    if (open_archive(decInfo, archive) == e_failure)
+        return e_failure;
+
+    // The trailer closes the data and points back at the table
+    stage_enter(&decInfo->clock, e_stage_data);
+    size = decInfo->size_secret_file;
+    if (size < 4 + ARCHIVE_TRAILER_SIZE || seek_data(decInfo, archive, size - ARCHIVE_TRAILER_SIZE) == e_failure ||
+        lsb_engine_extract(&decInfo->engine, (char *)trailer, ARCHIVE_TRAILER_SIZE) == e_failure)
+    {
+        decInfo->error = e_stego_corrupt;
+        stego_error("ERROR:❌ %s ends before its archive does\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+    archive->toc_offset = get_word(trailer);
+    if (archive->toc_offset > size - 4 - ARCHIVE_TRAILER_SIZE)
+    {
+        decInfo->error = e_stego_corrupt;
+        stego_error("ERROR:❌ Invalid table of contents offset in %s\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+
+    size -= archive->toc_offset + ARCHIVE_TRAILER_SIZE;
+    toc = malloc(size);
+    if (toc == NULL)
+    {
+        decInfo->error = e_stego_no_memory;
+        return e_failure;
+    }
+    ret = seek_data(decInfo, archive, archive->toc_offset);
+    if (ret == e_success)
+        ret = lsb_engine_extract(&decInfo->engine, (char *)toc, size);
+    if (ret == e_success && (crc32c_update(0, toc, size) != get_word(trailer + 4) ||
+                             parse_toc(decInfo, archive, toc, size) == e_failure))
+    {
+        if (decInfo->error != e_stego_no_memory)
+            decInfo->error = e_stego_corrupt;
+        stego_error("ERROR:❌ The table of contents of %s is corrupt\n", decInfo->stego_image_fname);
+        ret = e_failure;
+    }
+    free(toc);
+    if (ret == e_success)
+        decInfo->error = e_stego_ok;
+    return ret;
+}
+
+// The entry came out as the table says it went in
+static Status check_entry(DecodeInfo *decInfo, const StegoEntry *entry, uint32_t crc)
+{
+    if (crc == entry->crc)
+        return e_success;
+    decInfo->error = e_stego_corrupt;
+    stego_error("ERROR:❌ Checksum mismatch in %s: stored %08x, data gives %08x\n", entry->name, entry->crc, crc);
+    return e_failure;
+}
+
+// Decode entry into the open output file, a block at a time or in slices with -j
+static Status extract_entry(DecodeInfo *decInfo, const Archive *archive, const StegoEntry *entry)
+{
+    char *data;
+    long done, chunk;
+    uint32_t crc = 0;
+    Status ret = e_success;
+
+    // Slices are written at their offsets: a file, not stdout
+    if (decInfo->threads > 1 && strcmp(decInfo->secret_fname, STREAM_NAME) != 0)
+    {
+        int fd_out = fileno(decInfo->fptr_secret);
+
+        if (fflush(decInfo->fptr_secret) != 0 || ftruncate(fd_out, entry->size) != 0 ||
+            parallel_extract(fileno(decInfo->fptr_stego_image), &decInfo->engine.layout, fd_out,
+                             archive->data_start + LSB_CARRIER_SIZE(entry->offset, decInfo->bits), entry->size,
+                             decInfo->bits, decInfo->threads, &crc) == e_failure)
+            return e_failure;
+        return check_entry(decInfo, entry, crc);
+    }
+
+    data = malloc(LSB_PAYLOAD_BLOCK);
+    if (data == NULL || seek_data(decInfo, archive, entry->offset) == e_failure)
+    {
+        free(data);
+        return e_failure;
+    }
+    for (done = 0; done < entry->size; done += chunk)
+    {
+        chunk = entry->size - done;
+        if (chunk > LSB_PAYLOAD_BLOCK)
+            chunk = LSB_PAYLOAD_BLOCK;
+
+        if (lsb_engine_extract(&decInfo->engine, data, chunk) == e_failure ||
+            fwrite(data, 1, chunk, decInfo->fptr_secret) != (size_t)chunk)
+        {
+            ret = e_failure;
+            break;
+        }
+        crc = crc32c_update(crc, data, chunk);
+    }
+    free(data);
+    return ret == e_success ? check_entry(decInfo, entry, crc) : e_failure;
+}
+
+Status archive_extract(DecodeInfo *decInfo, const Archive *archive, const char *name)
+{
+    const StegoEntry *entry = NULL;
+    int i;
+
+    for (i = 0; i < archive->count && entry == NULL; i++)
+    {
+        if (strcmp(archive->entries[i].name, name) == 0)
+            entry = &archive->entries[i];
+    }
+    if (entry == NULL)
+    {
+        decInfo->error = e_stego_no_entry;
+        stego_error("ERROR:❌ %s holds no file called %s\n", decInfo->stego_image_fname, name);
+        return e_failure;
+    }
+
+    decInfo->error = e_stego_io;
+    stage_enter(&decInfo->clock, e_stage_open);
+    if (strcmp(decInfo->secret_fname, STREAM_NAME) == 0)
+        decInfo->fptr_secret = stdout;
+    else
+        decInfo->fptr_secret = fopen(decInfo->secret_fname, "w");
+    if (decInfo->fptr_secret == NULL)
+    {
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", decInfo->secret_fname, strerror(errno));
+        return e_failure;
+    }
+
+    stage_enter(&decInfo->clock, e_stage_data);
+    stego_info("📦 Extracting %s (%ld bytes) into %s\n", entry->name, entry->size, decInfo->secret_fname);
+    if (extract_entry(decInfo, archive, entry) == e_failure)
+    {
+        stego_error("ERROR:❌ Failed to extract %s from %s\n", entry->name, decInfo->stego_image_fname);
+        return e_failure;
+    }
+    decInfo->error = e_stego_ok;
+    return e_success;
+}
+
+void archive_free(Archive *archive)
+{
+    free(archive->entries);
+    archive->entries = NULL;
+    archive->count = 0;
+}
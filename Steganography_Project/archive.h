@@ -0,0 +1,39 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "types.h" // Contains user defined types
+#include "stego.h"
+#include "encode.h"
+#include "decode.h"
+
+/*
+ * Multi-file archives
+ * The files go through the data stage back to back and the table of
+ * contents after them (see common.h), so every file is read once while
+ * encoding. Listing decodes the header fields, the trailer and the
+ * table; extracting then seeks to the entry's first carrier byte, so
+ * nothing of the other entries is ever read.
+ */
+
+typedef struct Archive
+{
+    char *const *paths;  /* Files in embedding order, NULL for an archive read from an image */
+    StegoEntry *entries;
+    int count;
+    long toc_offset;     /* Data bytes before the table of contents */
+    long data_start;     /* Carrier byte of data byte 0 (decoding) */
+} Archive;
+
+/* Stat count files and lay them out behind encInfo; the CRCs are filled in while they are embedded */
+Status archive_prepare(EncodeInfo *encInfo, Archive *archive, char *const paths[], int count);
+
+/* Open the stego image of decInfo and decode the header fields and the table of contents */
+Status archive_read_toc(DecodeInfo *decInfo, Archive *archive);
+
+/* Decode the entry called name into decInfo->secret_fname, checking its CRC */
+Status archive_extract(DecodeInfo *decInfo, const Archive *archive, const char *name);
+
+/* Release the entries */
+void archive_free(Archive *archive);
+
+#endif
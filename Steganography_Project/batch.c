@@ -0,0 +1,265 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - batch mode over a job manifest
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "batch.h"
+#include "encode.h"
+#include "decode.h"
+#include "stego_log.h"
+#include "types.h"
+
+typedef struct
+{
+    int line;                          /* Manifest line number */
+    int nfields;
+    char *text;                        /* Owned copy of the line, fields point into it */
+    char *fields[MAX_MANIFEST_FIELDS];
+    Status status;
+    long bytes;                        /* Payload bytes hidden or recovered */
+    double seconds;
+    char message[MAX_ERROR_MSG];
+} BatchJob;
+
+typedef struct
+{
+    BatchJob *jobs;
+    int count;
+    int next;                          /* Next job to hand out, taken atomically */
+    int failed;
+    const StegoOptions *options;       /* Applied to every job */
+    pthread_mutex_t report_lock;       /* Keeps report lines whole */
+} BatchQueue;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Read the manifest into jobs, one per non-empty line
+static Status load_manifest(const char *manifest, BatchQueue *queue)
+{
+    FILE *fptr = fopen(manifest, "r");
+    char *line = NULL, *save, *field;
+    size_t cap = 0;
+    int i, lineno = 0, alloc = 0;
+    Status ret = e_success;
+    BatchJob *job;
+
+    if (fptr == NULL)
+    {
+        perror("fopen");
+        fprintf(stderr, "ERROR:❌ Unable to open manifest %s\n", manifest);
+        return e_failure;
+    }
+
+    queue->jobs = NULL;
+    queue->count = 0;
+    while (getline(&line, &cap, fptr) != -1)
+    {
+        lineno++;
+        field = line + strspn(line, " \t\r\n");
+        if (*field == '\0' || *field == '#')
+            continue;
+
+        if (queue->count == alloc)
+        {
+            alloc = alloc ? alloc * 2 : 64;
+            job = realloc(queue->jobs, alloc * sizeof(BatchJob));
+            if (job == NULL)
+            {
+                ret = e_failure;
+                break;
+            }
+            queue->jobs = job;
+        }
+
+        job = &queue->jobs[queue->count++];
+        memset(job, 0, sizeof(*job));
+        job->line = lineno;
+        job->text = strdup(line);
+        if (job->text == NULL)
+        {
+            ret = e_failure;
+            break;
+        }
+
+        // Whitespace separated fields; a fourth field makes the line malformed
+        for (field = strtok_r(job->text, " \t\r\n", &save); field != NULL; field = strtok_r(NULL, " \t\r\n", &save))
+        {
+            if (job->nfields == MAX_MANIFEST_FIELDS)
+            {
+                job->nfields++;
+                break;
+            }
+            job->fields[job->nfields++] = field;
+        }
+    }
+
+    free(line);
+    fclose(fptr);
+
+    // A batch missing the lines after this one would report success for work it never did
+    if (ret == e_failure)
+    {
+        fprintf(stderr, "ERROR:❌ Out of memory reading manifest %s at line %d\n", manifest, lineno);
+        for (i = 0; i < queue->count; i++)
+            free(queue->jobs[i].text);
+        free(queue->jobs);
+    }
+    return ret;
+}
+
+// Run one encode or decode job on the calling thread, silently
+static void run_job(BatchJob *job, const StegoOptions *options)
+{
+    EncodeInfo encInfo;
+    DecodeInfo decInfo;
+    char *args[6] = {"a.out", NULL, NULL, NULL, NULL, NULL};
+    double start = now_seconds();
+
+    stego_reset_error();
+    job->status = e_failure;
+
+    if (job->nfields == 3)
+    {
+        args[1] = "-e";
+        args[2] = job->fields[0];
+        args[3] = job->fields[1];
+        args[4] = job->fields[2];
+        if (read_and_validate_encode_args(args, &encInfo) == e_success)
+        {
+            encInfo.bits = options->bits;
+            encInfo.compress = options->compress;
+            encInfo.crc = options->crc;
+            encInfo.key = options->key;
+            encInfo.scatter = options->scatter;
+            encInfo.fec = options->fec;
+            job->status = do_encoding(&encInfo);
+            close_encode_files(&encInfo);
+            job->bytes = encInfo.size_secret_file;
+        }
+    }
+    else if (job->nfields == 2)
+    {
+        args[1] = "-d";
+        args[2] = job->fields[0];
+        args[3] = job->fields[1];
+        if (read_and_validate_decode_args(args, &decInfo) == e_success)
+        {
+            decInfo.key = options->key;
+            job->status = do_decoding(&decInfo);
+            close_decode_files(&decInfo);
+            job->bytes = decInfo.size_secret_file;
+        }
+    }
+    else
+    {
+        stego_error("❌ Expected <cover> <secret> <stego> or <stego> <output>\n");
+    }
+
+    job->seconds = now_seconds() - start;
+    snprintf(job->message, sizeof(job->message), "%s",
+             job->status == e_success ? "" : (*stego_first_error() ? stego_first_error() : "❌ Failed"));
+}
+
+// Print one status line per finished job
+static void report_job(BatchQueue *queue, BatchJob *job)
+{
+    pthread_mutex_lock(&queue->report_lock);
+    if (job->status == e_success)
+    {
+        printf("✅ [line %d] %s %s -> %s (%ld bytes, %.3f ms)\n", job->line,
+               job->nfields == 3 ? "encoded" : "decoded",
+               job->nfields == 3 ? job->fields[1] : job->fields[0],
+               job->nfields == 3 ? job->fields[2] : job->fields[1],
+               job->bytes, job->seconds * 1e3);
+    }
+    else
+    {
+        queue->failed++;
+        printf("❌ [line %d] FAILED: %s\n", job->line, job->message);
+    }
+    pthread_mutex_unlock(&queue->report_lock);
+}
+
+// Worker: take jobs until the queue is empty
+static void *batch_worker(void *arg)
+{
+    BatchQueue *queue = arg;
+    int i;
+
+    stego_set_quiet(1);
+    while ((i = __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED)) < queue->count)
+    {
+        run_job(&queue->jobs[i], queue->options);
+        report_job(queue, &queue->jobs[i]);
+    }
+    return NULL;
+}
+
+Status run_batch(const char *manifest, int workers, const StegoOptions *options)
+{
+    BatchQueue queue;
+    pthread_t *tids;
+    double start, seconds;
+    long total = 0;
+    int i, started;
+
+    if (load_manifest(manifest, &queue) == e_failure)
+        return e_failure;
+
+    queue.next = 0;
+    queue.failed = 0;
+    queue.options = options;
+    pthread_mutex_init(&queue.report_lock, NULL);
+    if (workers > queue.count)
+        workers = queue.count;
+    if (workers < 1)
+        workers = 1;
+
+    printf("------------------------------------------------\n");
+    printf("    INFO: ## Batch of %d jobs on %d workers ## \n", queue.count, workers);
+    printf("------------------------------------------------\n");
+
+    start = now_seconds();
+    tids = malloc(workers * sizeof(pthread_t));
+    for (started = 0; tids != NULL && started < workers; started++)
+    {
+        if (pthread_create(&tids[started], NULL, batch_worker, &queue) != 0)
+            break;
+    }
+    // No thread at all: run the queue here
+    if (started == 0)
+        batch_worker(&queue);
+    for (i = 0; i < started; i++)
+        pthread_join(tids[i], NULL);
+    seconds = now_seconds() - start;
+
+    for (i = 0; i < queue.count; i++)
+    {
+        if (queue.jobs[i].status == e_success)
+            total += queue.jobs[i].bytes;
+        free(queue.jobs[i].text);
+    }
+
+    printf("--------------------------------------------------\n");
+    printf("📦 %d jobs: %d ok, %d failed in %.3f s\n", queue.count, queue.count - queue.failed, queue.failed, seconds);
+    printf("📦 Throughput: %.1f jobs/s, %.2f MB/s of payload\n",
+           seconds > 0 ? queue.count / seconds : 0.0, seconds > 0 ? total / seconds / 1e6 : 0.0);
+    printf("--------------------------------------------------\n");
+
+    pthread_mutex_destroy(&queue.report_lock);
+    free(tids);
+    free(queue.jobs);
+    return queue.failed == 0 ? e_success : e_failure;
+}
@@ -0,0 +1,24 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "types.h" // Contains user defined types
+#include "stego.h"
+
+/*
+ * Batch mode
+ * Each non-blank manifest line that does not start with '#' is a job:
+ *   <cover.bmp> <secret.txt|.c|.sh> <stego.bmp>   encode
+ *   <stego.bmp> <output_name>                     decode
+ * Jobs run on a fixed pool of worker threads in no particular order,
+ * so a decode must not depend on an encode of the same batch. A
+ * failing job is reported and the rest of the batch carries on. The
+ * encode options (-k, -z, --no-crc, -K, --scatter, --fec) hold for every
+ * encode, the key for every decode.
+ */
+
+#define MAX_MANIFEST_FIELDS 3
+
+/* Run every job of manifest on workers threads with options, e_failure if any job failed */
+Status run_batch(const char *manifest, int workers, const StegoOptions *options);
+
+#endif
@@ -0,0 +1,398 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - benchmark over synthetic covers and payloads
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "stego.h"
+
+#define MAX_LIST 16
+#define GEN_BLOCK (1 << 20)
+
+// Comma separated numbers from the command line
+typedef struct
+{
+    int count;
+    int values[MAX_LIST];
+} List;
+
+typedef struct
+{
+    List megapixels;  /* -s: cover sizes */
+    List fills;       /* -f: payload as a percentage of the cover's capacity */
+    List bits;        /* -k: densities */
+    int threads;      /* -j */
+    int reps;         /* -r: best of */
+    const char *dir;  /* -d: where the synthetic files go */
+    int json;
+} BenchConfig;
+
+// What a child process sends back for one run
+typedef struct
+{
+    StegoError err;
+    StegoStats stats;
+} RunResult;
+
+typedef struct
+{
+    const char *op;
+    int megapixels;
+    int fill;
+    int bits;
+    long payload;
+    long image;
+    StegoStats stats; /* Of the fastest repetition */
+    long peak_rss_kb;
+} Run;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+// xorshift64*: fast enough that generating 600 MB covers is disk bound
+static uint64_t next_random(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static void fill_random(unsigned char *buf, long size)
+{
+    uint64_t r;
+    long i;
+
+    for (i = 0; i + 8 <= size; i += 8)
+    {
+        r = next_random();
+        memcpy(buf + i, &r, 8);
+    }
+    for (r = next_random(); i < size; i++, r >>= 8)
+        buf[i] = r;
+}
+
+static int parse_list(const char *text, List *list)
+{
+    char *end;
+
+    list->count = 0;
+    while (*text != '\0' && list->count < MAX_LIST)
+    {
+        list->values[list->count++] = strtol(text, &end, 10);
+        if (end == text || list->values[list->count - 1] <= 0 || (*end != ',' && *end != '\0'))
+            return -1;
+        text = *end == ',' ? end + 1 : end;
+    }
+    return list->count > 0 ? 0 : -1;
+}
+
+// Write size bytes of random data after header
+static int write_random_file(const char *path, const unsigned char *header, long header_size, long size)
+{
+    FILE *fptr = fopen(path, "w");
+    unsigned char *block = malloc(GEN_BLOCK);
+    long left, n;
+    int ret = -1;
+
+    if (fptr != NULL && block != NULL && fwrite(header, 1, header_size, fptr) == (size_t)header_size)
+    {
+        for (left = size; left > 0; left -= n)
+        {
+            n = left < GEN_BLOCK ? left : GEN_BLOCK;
+            fill_random(block, n);
+            if (fwrite(block, 1, n, fptr) != (size_t)n)
+                break;
+        }
+        ret = left > 0 ? -1 : 0;
+    }
+    if (fptr != NULL && fclose(fptr) != 0)
+        ret = -1;
+    free(block);
+    return ret;
+}
+
+static void put_le32(unsigned char *p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+// 24 bpp cover of about megapixels million pixels, width a multiple of 4 so rows are unpadded
+static int make_cover(const char *path, int megapixels, long *image_size)
+{
+    unsigned char header[54] = {'B', 'M'};
+    long width = 4, height, pixels = (long)megapixels * 1000000;
+
+    while ((width + 4) * (width + 4) <= pixels)
+        width += 4;
+    height = pixels / width;
+
+    put_le32(header + 2, 54 + width * height * 3);
+    put_le32(header + 10, 54);
+    put_le32(header + 14, 40);
+    put_le32(header + 18, width);
+    put_le32(header + 22, height);
+    header[26] = 1;
+    header[28] = 24;
+    put_le32(header + 34, width * height * 3);
+    *image_size = 54 + width * height * 3;
+    return write_random_file(path, header, sizeof(header), width * height * 3);
+}
+
+// Run one encode (secret set) or decode in a child process, so its peak RSS is its own
+static int run_child(const BenchConfig *config, int bits, const char *input, const char *secret, const char *output,
+                     RunResult *result, long *peak_rss_kb)
+{
+    StegoOptions options;
+    struct rusage usage;
+    int fds[2], status, ok;
+    pid_t pid;
+
+    if (pipe(fds) != 0)
+        return -1;
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0)
+    {
+        close(fds[0]);
+        stego_options_init(&options);
+        options.threads = config->threads;
+        options.bits = bits;
+        options.stats = &result->stats;
+        result->err = secret != NULL ? stego_encode_file(input, secret, output, &options)
+                                     : stego_decode_file(input, output, &options);
+        _exit(write(fds[1], result, sizeof(*result)) == sizeof(*result) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ok = read(fds[0], result, sizeof(*result)) == sizeof(*result);
+    close(fds[0]);
+    if (wait4(pid, &status, 0, &usage) < 0 || !ok)
+        return -1;
+    *peak_rss_kb = usage.ru_maxrss;
+    return 0;
+}
+
+// Best of config->reps runs; the peak RSS is the largest seen
+static int measure(const BenchConfig *config, int bits, const char *input, const char *secret, const char *output,
+                   Run *run)
+{
+    RunResult result;
+    long rss;
+    int rep;
+
+    run->peak_rss_kb = 0;
+    for (rep = 0; rep < config->reps; rep++)
+    {
+        if (run_child(config, bits, input, secret, output, &result, &rss) != 0)
+            return -1;
+        if (result.err != e_stego_ok)
+        {
+            fprintf(stderr, "❌ %s of %s failed: %s\n", run->op, input, stego_strerror(result.err));
+            return -1;
+        }
+        if (rep == 0 || result.stats.total < run->stats.total)
+            run->stats = result.stats;
+        if (rss > run->peak_rss_kb)
+            run->peak_rss_kb = rss;
+    }
+    return 0;
+}
+
+// Both files hold the same bytes
+static int same_contents(const char *a, const char *b)
+{
+    FILE *fa = fopen(a, "r"), *fb = fopen(b, "r");
+    unsigned char *ba = malloc(GEN_BLOCK), *bb = malloc(GEN_BLOCK);
+    size_t na, nb;
+    int same = fa != NULL && fb != NULL && ba != NULL && bb != NULL;
+
+    while (same)
+    {
+        na = fread(ba, 1, GEN_BLOCK, fa);
+        nb = fread(bb, 1, GEN_BLOCK, fb);
+        same = na == nb && memcmp(ba, bb, na) == 0;
+        if (na == 0)
+            break;
+    }
+    if (fa != NULL)
+        fclose(fa);
+    if (fb != NULL)
+        fclose(fb);
+    free(ba);
+    free(bb);
+    return same;
+}
+
+static double mb_per_s(long bytes, double seconds)
+{
+    return seconds > 0 ? bytes / seconds / 1e6 : 0;
+}
+
+static double ns_per_byte(long bytes, double seconds)
+{
+    return bytes > 0 ? seconds * 1e9 / bytes : 0;
+}
+
+static void print_run_text(const Run *run)
+{
+    double data = run->stats.seconds[e_stage_data];
+    int i;
+
+    printf("%-6s %4d MP  k=%d  %3d%%  %10ld B  %8.4f s  %8.1f MB/s  data %8.1f MB/s %7.2f ns/B  RSS %6.1f MB\n",
+           run->op, run->megapixels, run->bits, run->fill, run->payload, run->stats.total,
+           mb_per_s(run->image, run->stats.total), mb_per_s(run->payload, data), ns_per_byte(run->payload, data),
+           run->peak_rss_kb / 1024.0);
+    printf("       ");
+    for (i = 0; i < STEGO_STAGE_COUNT; i++)
+    {
+        if (run->stats.seconds[i] > 0)
+            printf(" %s %.4f", stego_stage_name(i), run->stats.seconds[i]);
+    }
+    printf("\n");
+}
+
+static void print_run_json(const Run *run, int first)
+{
+    double data = run->stats.seconds[e_stage_data];
+    int i;
+
+    printf("%s\n    {\"op\": \"%s\", \"megapixels\": %d, \"bits\": %d, \"fill\": %d, \"payload_bytes\": %ld, "
+           "\"image_bytes\": %ld, \"seconds\": %.6f, \"mb_per_s\": %.3f, \"data_mb_per_s\": %.3f, "
+           "\"data_ns_per_byte\": %.4f, \"peak_rss_kb\": %ld, \"stages\": {",
+           first ? "" : ",", run->op, run->megapixels, run->bits, run->fill, run->payload, run->image,
+           run->stats.total, mb_per_s(run->image, run->stats.total), mb_per_s(run->payload, data),
+           ns_per_byte(run->payload, data), run->peak_rss_kb);
+    for (i = 0; i < STEGO_STAGE_COUNT; i++)
+        printf("%s\"%s\": %.6f", i ? ", " : "", stego_stage_name(i), run->stats.seconds[i]);
+    printf("}}");
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "Usage: ./stego_bench [-s megapixels,...] [-f fill%%,...] [-k 1|2|4,...] [-j threads] "
+                    "[-r repetitions] [-d dir] [--json]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config = {{5, {1, 4, 16, 64, 200}}, {4, {1, 10, 50, 100}}, {3, {1, 2, 4}}, 1, 3, "/tmp", 0};
+    char cover[4096], secret[4096], stego[4096], output[4096], decoded[4100];
+    StegoCoverInfo info;
+    unsigned char none[1];
+    Run run;
+    int s, k, f, i, first = 1, failed = 0, level;
+    long image;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            config.json = 1;
+        else if (i + 1 < argc && strcmp(argv[i], "-s") == 0)
+            failed |= parse_list(argv[++i], &config.megapixels);
+        else if (i + 1 < argc && strcmp(argv[i], "-f") == 0)
+            failed |= parse_list(argv[++i], &config.fills);
+        else if (i + 1 < argc && strcmp(argv[i], "-k") == 0)
+            failed |= parse_list(argv[++i], &config.bits);
+        else if (i + 1 < argc && strcmp(argv[i], "-j") == 0)
+            config.threads = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-r") == 0)
+            config.reps = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-d") == 0)
+            config.dir = argv[++i];
+        else
+            failed = 1;
+    }
+    for (i = 0; i < config.fills.count; i++)
+        failed |= config.fills.values[i] > 100;
+    for (i = 0; i < config.bits.count; i++)
+        failed |= config.bits.values[i] != 1 && config.bits.values[i] != 2 && config.bits.values[i] != 4;
+    if (failed || config.threads < 1 || config.reps < 1)
+    {
+        usage();
+        return 1;
+    }
+
+    snprintf(secret, sizeof(secret), "%s/stego_bench_%d.txt", config.dir, (int)getpid());
+    snprintf(stego, sizeof(stego), "%s/stego_bench_%d_out.bmp", config.dir, (int)getpid());
+    snprintf(output, sizeof(output), "%s/stego_bench_%d_decoded", config.dir, (int)getpid());
+    snprintf(decoded, sizeof(decoded), "%s.txt", output);
+
+    if (config.json)
+        printf("{\"version\": 1, \"threads\": %d, \"repetitions\": %d, \"runs\": [", config.threads, config.reps);
+    for (s = 0; s < config.megapixels.count && !failed; s++)
+    {
+        snprintf(cover, sizeof(cover), "%s/stego_bench_%d_%dmp.bmp", config.dir, (int)getpid(),
+                 config.megapixels.values[s]);
+        if (!config.json)
+            printf("📝 Generating a %d MP cover\n", config.megapixels.values[s]);
+        if (make_cover(cover, config.megapixels.values[s], &image) != 0 || stego_analyze_file(cover, &info) != e_stego_ok)
+        {
+            fprintf(stderr, "❌ Unable to write %s: %s\n", cover, strerror(errno));
+            failed = 1;
+            break;
+        }
+
+        for (k = 0; k < config.bits.count && !failed; k++)
+        {
+            level = __builtin_ctz(config.bits.values[k]);
+            for (f = 0; f < config.fills.count && !failed; f++)
+            {
+                run.megapixels = config.megapixels.values[s];
+                run.bits = config.bits.values[k];
+                run.fill = config.fills.values[f];
+                run.image = image;
+                run.payload = info.max_payload[level] / 100 * run.fill +
+                              info.max_payload[level] % 100 * run.fill / 100;
+                if (write_random_file(secret, none, 0, run.payload) != 0)
+                {
+                    fprintf(stderr, "❌ Unable to write %s: %s\n", secret, strerror(errno));
+                    failed = 1;
+                    break;
+                }
+
+                run.op = "encode";
+                if (measure(&config, run.bits, cover, secret, stego, &run) != 0)
+                {
+                    failed = 1;
+                    break;
+                }
+                config.json ? print_run_json(&run, first) : print_run_text(&run);
+                first = 0;
+
+                run.op = "decode";
+                if (measure(&config, run.bits, stego, NULL, output, &run) != 0 || !same_contents(secret, decoded))
+                {
+                    fprintf(stderr, "❌ Decoded payload differs from %s\n", secret);
+                    failed = 1;
+                    break;
+                }
+                config.json ? print_run_json(&run, first) : print_run_text(&run);
+            }
+        }
+        unlink(cover);
+    }
+    if (config.json)
+        printf("\n]}\n");
+
+    unlink(secret);
+    unlink(stego);
+    unlink(decoded);
+    return failed;
+}
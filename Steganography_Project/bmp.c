@@ -0,0 +1,324 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - BMP container layout
+*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "bmp.h"
+#include "common.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define BMP_X86 1
+#endif
+
+#define BI_RGB 0
+#define BI_BITFIELDS 3
+#define BI_ALPHABITFIELDS 6
+
+// Drop or restore the fourth byte of 32 bpp pixels
+typedef void (*PixelsFn)(long pos, long size, const unsigned char *from, unsigned char *to);
+
+static PixelsFn gather32;
+static PixelsFn scatter32;
+
+static uint32_t le32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t le16(const unsigned char *p)
+{
+    return p[0] | p[1] << 8;
+}
+
+// Older encoders wrote from byte 54 on over whatever was there, V4/V5 bit field masks included:
+// their magic string in the LSBs of the bytes from 54 on marks such an image
+static int legacy_magic(const unsigned char *header, long size)
+{
+    const char *magic = MAGIC_STRING;
+    long i, bits = strlen(magic) * 8;
+    unsigned char ch = 0;
+
+    if (size < BMP_LEGACY_OFFSET + bits)
+        return 0;
+    for (i = 0; i < bits; i++)
+    {
+        ch = ch << 1 | (header[BMP_LEGACY_OFFSET + i] & 1);
+        if (i % 8 == 7 && ch != (unsigned char)magic[i / 8])
+            return 0;
+    }
+    return 1;
+}
+
+// Headers of a cover, or with stego of an image to decode, whose masks may have gone to a legacy encode
+static Status parse_headers(const unsigned char *header, long size, long file_size, BmpLayout *layout, int stego)
+{
+    uint32_t offset, header_size, compression;
+    int32_t width, height;
+    uint16_t planes, bpp;
+
+    if (header == NULL || size < BMP_LEGACY_OFFSET || header[0] != 'B' || header[1] != 'M')
+        return e_failure;
+
+    offset = le32(header + 10);
+    header_size = le32(header + 14);
+    width = (int32_t)le32(header + 18);
+    height = (int32_t)le32(header + 22);
+    planes = le16(header + 26);
+    bpp = le16(header + 28);
+    compression = le32(header + 30);
+
+    // BITMAPINFOHEADER or a later version of it, uncompressed 24 or 32 bpp
+    if (header_size < 40 || planes != 1 || (bpp != 24 && bpp != 32) || width <= 0 || height == 0 ||
+        height == INT32_MIN || offset < BMP_FILE_HEADER_SIZE + header_size)
+        return e_failure;
+
+    // Bit fields are fine as long as blue, green and red are the low three bytes
+    if (compression == BI_BITFIELDS || compression == BI_ALPHABITFIELDS)
+    {
+        if (bpp != 32 || size < BMP_LEGACY_OFFSET + 12 || offset < BMP_LEGACY_OFFSET + 12)
+            return e_failure;
+        if ((le32(header + 54) != 0x00FF0000 || le32(header + 58) != 0x0000FF00 || le32(header + 62) != 0x000000FF) &&
+            !(stego && legacy_magic(header, size)))
+            return e_failure;
+    }
+    else if (compression != BI_RGB)
+    {
+        return e_failure;
+    }
+
+    layout->offset = offset;
+    layout->width = width;
+    layout->top_down = height < 0;
+    layout->height = height < 0 ? -(long)height : height;
+    layout->bpp = bpp;
+    layout->stride = ((long)width * bpp + 31) / 32 * 4;
+    layout->row_bytes = (long)width * 3;
+    layout->usable = layout->row_bytes * layout->height;
+    layout->packed = bpp == 24 && layout->stride == layout->row_bytes;
+
+    // The whole pixel array must be there
+    if (file_size >= 0 && layout->offset + layout->stride * layout->height > file_size)
+        return e_failure;
+    return e_success;
+}
+
+Status bmp_parse(const unsigned char *header, long size, long file_size, BmpLayout *layout)
+{
+    return parse_headers(header, size, file_size, layout, 0);
+}
+
+Status bmp_parse_stego(const unsigned char *header, long size, long file_size, BmpLayout *layout)
+{
+    return parse_headers(header, size, file_size, layout, 1);
+}
+
+Status bmp_read_layout(FILE *fptr, BmpLayout *layout, int stego)
+{
+    unsigned char header[BMP_MAX_HEADER_SIZE];
+    struct stat st;
+    ssize_t size;
+
+    // pread: the caller's stdio position and buffer stay as they were
+    size = pread(fileno(fptr), header, sizeof(header), 0);
+    if (size < 0 || fstat(fileno(fptr), &st) != 0)
+        return e_failure;
+    return parse_headers(header, size, S_ISREG(st.st_mode) ? st.st_size : -1, layout, stego);
+}
+
+Status bmp_read_stream(FILE *fptr, unsigned char **head, BmpLayout *layout, int stego)
+{
+    unsigned char file_header[BMP_FILE_HEADER_SIZE];
+    long offset;
+
+    // The file header says how much comes before the pixels: read exactly that, no further
+    *head = NULL;
+    if (fread(file_header, 1, sizeof(file_header), fptr) != sizeof(file_header))
+        return e_failure;
+    offset = le32(file_header + 10);
+    if (offset < BMP_LEGACY_OFFSET || offset > BMP_MAX_STREAM_HEAD)
+        return e_failure;
+    *head = malloc(offset);
+    if (*head == NULL)
+        return e_failure;
+    memcpy(*head, file_header, sizeof(file_header));
+    if (fread(*head + sizeof(file_header), 1, offset - sizeof(file_header), fptr) != (size_t)(offset - sizeof(file_header)) ||
+        parse_headers(*head, offset, -1, layout, stego) == e_failure)
+    {
+        free(*head);
+        *head = NULL;
+        return e_failure;
+    }
+    return e_success;
+}
+
+void bmp_legacy_layout(const BmpLayout *layout, BmpLayout *legacy)
+{
+    *legacy = *layout;
+    legacy->offset = BMP_LEGACY_OFFSET;
+    legacy->bpp = 24;
+    legacy->usable = layout->width * layout->height * 3 - BMP_LEGACY_OFFSET;
+    if (legacy->usable < 0)
+        legacy->usable = 0;
+
+    // One long row: carrier byte pos is file byte 54 + pos
+    legacy->stride = legacy->row_bytes = legacy->usable > 0 ? legacy->usable : 1;
+    legacy->packed = 1;
+}
+
+int bmp_matches_legacy(const BmpLayout *layout)
+{
+    return layout->packed && layout->offset == BMP_LEGACY_OFFSET;
+}
+
+long bmp_offset(const BmpLayout *layout, long pos)
+{
+    // 32 bpp rows are never padded: pixels run on across rows
+    if (layout->bpp == 32)
+        return layout->offset + pos / 3 * 4 + pos % 3;
+    return layout->offset + pos / layout->row_bytes * layout->stride + pos % layout->row_bytes;
+}
+
+// One byte at a time, stepping over the fourth byte of every pixel
+static void gather32_scalar(long pos, long size, const unsigned char *span, unsigned char *carrier)
+{
+    while (size-- > 0)
+    {
+        *carrier++ = *span++;
+        if (++pos % 3 == 0)
+            span++;
+    }
+}
+
+static void scatter32_scalar(long pos, long size, const unsigned char *carrier, unsigned char *span)
+{
+    while (size-- > 0)
+    {
+        *span++ = *carrier++;
+        if (++pos % 3 == 0)
+            span++;
+    }
+}
+
+#ifdef BMP_X86
+// Four aligned pixels per shuffle: 16 span bytes <-> 12 carrier bytes
+__attribute__((target("ssse3"))) static void gather32_ssse3(long pos, long size, const unsigned char *span,
+                                                            unsigned char *carrier)
+{
+    const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    long head = (3 - pos % 3) % 3;
+
+    // Finish a pixel split by the previous block
+    if (head > size)
+        head = size;
+    gather32_scalar(pos, head, span, carrier);
+    span += head + (head > 0);
+    carrier += head;
+    size -= head;
+
+    // 16-byte stores of 12 bytes: stop while 16 carrier bytes are still ours
+    for (; size >= 16; size -= 12, span += 16, carrier += 12)
+        _mm_storeu_si128((__m128i *)carrier, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)span), pack));
+    gather32_scalar(0, size, span, carrier);
+}
+
+__attribute__((target("ssse3"))) static void scatter32_ssse3(long pos, long size, const unsigned char *carrier,
+                                                             unsigned char *span)
+{
+    const __m128i spread = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i keep = _mm_setr_epi8(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+    long head = (3 - pos % 3) % 3;
+    __m128i pixels;
+
+    if (head > size)
+        head = size;
+    scatter32_scalar(pos, head, carrier, span);
+    span += head + (head > 0);
+    carrier += head;
+    size -= head;
+
+    // 16-byte loads of 12 carrier bytes, the fourth pixel byte kept from the span
+    for (; size >= 16; size -= 12, span += 16, carrier += 12)
+    {
+        pixels = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)carrier), spread);
+        pixels = _mm_or_si128(pixels, _mm_and_si128(_mm_loadu_si128((const __m128i *)span), keep));
+        _mm_storeu_si128((__m128i *)span, pixels);
+    }
+    scatter32_scalar(0, size, carrier, span);
+}
+#endif
+
+void bmp_gather(const BmpLayout *layout, long pos, long size, const unsigned char *span, unsigned char *carrier)
+{
+    long col, n;
+
+    if (layout->packed)
+    {
+        memcpy(carrier, span, size);
+        return;
+    }
+    if (layout->bpp == 32)
+    {
+        gather32(pos, size, span, carrier);
+        return;
+    }
+
+    // 24 bpp: whole row runs, padding skipped
+    for (col = pos % layout->row_bytes; size > 0; col = 0)
+    {
+        n = layout->row_bytes - col;
+        if (n > size)
+            n = size;
+        memcpy(carrier, span, n);
+        carrier += n;
+        size -= n;
+        span += n + layout->stride - layout->row_bytes;
+    }
+}
+
+void bmp_scatter(const BmpLayout *layout, long pos, long size, const unsigned char *carrier, unsigned char *span)
+{
+    long col, n;
+
+    if (layout->packed)
+    {
+        memcpy(span, carrier, size);
+        return;
+    }
+    if (layout->bpp == 32)
+    {
+        scatter32(pos, size, carrier, span);
+        return;
+    }
+
+    for (col = pos % layout->row_bytes; size > 0; col = 0)
+    {
+        n = layout->row_bytes - col;
+        if (n > size)
+            n = size;
+        memcpy(span, carrier, n);
+        carrier += n;
+        size -= n;
+        span += n + layout->stride - layout->row_bytes;
+    }
+}
+
+// Shuffle-based pixel packing where the CPU has it
+__attribute__((constructor)) static void bmp_init(void)
+{
+    gather32 = gather32_scalar;
+    scatter32 = scatter32_scalar;
+#ifdef BMP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        gather32 = gather32_ssse3;
+        scatter32 = scatter32_ssse3;
+    }
+#endif
+}
@@ -0,0 +1,66 @@
+#ifndef BMP_H
+#define BMP_H
+
+#include <stdio.h>
+#include "types.h" // Contains user defined types
+
+/*
+ * BMP container layout
+ * The carrier is the B, G and R byte of every pixel in file order, so row
+ * padding and the fourth byte of 32 bpp pixels are never modified.
+ * Carrier byte pos lives at file offset bmp_offset(layout, pos); the file
+ * bytes of a carrier range are its span, gaps included.
+ */
+
+#define BMP_FILE_HEADER_SIZE 14
+#define BMP_LEGACY_OFFSET 54     /* File header + BITMAPINFOHEADER, where old encoders started */
+#define BMP_MAX_HEADER_SIZE 138  /* File header + BITMAPV5HEADER: all bmp_parse() looks at */
+#define BMP_MAX_STREAM_HEAD (1 << 20) /* Most bytes before the pixel array held for a streamed BMP */
+
+/* Largest span of n carrier bytes (4/3 of them for 32 bpp or narrow padded rows) */
+#define BMP_SPAN_SIZE(n) ((n) / 3 * 4 + 8)
+
+typedef struct
+{
+    long offset;    /* bfOffBits: first byte of the pixel array */
+    long width;
+    long height;    /* Rows, positive for top-down images too */
+    int top_down;   /* biHeight was negative: the top row comes first */
+    int bpp;        /* 24 or 32 */
+    long stride;    /* File bytes per row, padding included */
+    long row_bytes; /* Carrier bytes per row */
+    long usable;    /* Carrier bytes in the image */
+    int packed;     /* The carrier is one contiguous run of file bytes */
+} BmpLayout;
+
+/* Parse the headers at the start of a BMP of file_size bytes (-1: unknown) */
+Status bmp_parse(const unsigned char *header, long size, long file_size, BmpLayout *layout);
+
+/* bmp_parse() for an image to decode: bit field masks that an older encoder overwrote (its
+ * magic string is in the LSBs from byte 54 on) do not reject it */
+Status bmp_parse_stego(const unsigned char *header, long size, long file_size, BmpLayout *layout);
+
+/* Read only the headers of an open BMP, leaving its file position alone, and parse them
+ * (as bmp_parse_stego() does when stego is 1) */
+Status bmp_read_layout(FILE *fptr, BmpLayout *layout, int stego);
+
+/* Read everything before the pixel array of a BMP arriving on a stream into *head (malloc'd,
+ * layout->offset bytes) and parse it; the stream is left at the first pixel */
+Status bmp_read_stream(FILE *fptr, unsigned char **head, BmpLayout *layout, int stego);
+
+/* Layout older encoders used: every byte from offset 54 on, up to width * height * 3 */
+void bmp_legacy_layout(const BmpLayout *layout, BmpLayout *legacy);
+
+/* 1 when layout puts the carrier where older encoders did */
+int bmp_matches_legacy(const BmpLayout *layout);
+
+/* File offset of carrier byte pos; pos == usable gives the end of the pixel array */
+long bmp_offset(const BmpLayout *layout, long pos);
+
+/* Copy carrier bytes [pos, pos + size) out of their span into carrier */
+void bmp_gather(const BmpLayout *layout, long pos, long size, const unsigned char *span, unsigned char *carrier);
+
+/* Put carrier bytes [pos, pos + size) back into their span, other span bytes untouched */
+void bmp_scatter(const BmpLayout *layout, long pos, long size, const unsigned char *carrier, unsigned char *span);
+
+#endif
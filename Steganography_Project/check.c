@@ -0,0 +1,413 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - known answer and round trip checks of the on-image formats
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "stego.h"
+#include "crc32c.h"
+#include "aead.h"
+#include "lz.h"
+#include "fec.h"
+#include "lsb_kernels.h"
+
+#define COVER_WIDTH 512
+#define COVER_HEIGHT 256
+#define COVER_SIZE (54 + COVER_WIDTH * COVER_HEIGHT * 3)
+#define PAYLOAD_SIZE 6000
+
+static int checks;
+static int failures;
+
+// Count one check, and name it when it fails
+static void check(int ok, const char *what)
+{
+    checks++;
+    if (!ok)
+    {
+        failures++;
+        printf("❌ FAILED: %s\n", what);
+    }
+}
+
+static uint64_t rng_state;
+
+// xorshift64*, seeded per section so each one sees the same data on every run
+static uint64_t next_random(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static void fill_random(unsigned char *buf, long size)
+{
+    long i;
+
+    for (i = 0; i < size; i++)
+        buf[i] = next_random() >> 56;
+}
+
+// Words from a short list: text that compresses, unlike fill_random
+static void fill_text(unsigned char *buf, long size)
+{
+    static const char *words[] = {"stego ", "carrier ", "payload ", "bitmap ", "hidden ", "pixel ", "key\n"};
+    const char *word;
+    long i = 0;
+
+    while (i < size)
+    {
+        for (word = words[next_random() % 7]; *word != '\0' && i < size; word++)
+            buf[i++] = *word;
+    }
+}
+
+// Bit at a time CRC32C: slow, but nothing in it to get wrong
+static uint32_t crc32c_reference(const unsigned char *data, size_t size)
+{
+    uint32_t crc = ~0U;
+    size_t i;
+    int j;
+
+    for (i = 0; i < size; i++)
+    {
+        crc ^= data[i];
+        for (j = 0; j < 8; j++)
+            crc = crc & 1 ? (crc >> 1) ^ 0x82F63B78U : crc >> 1;
+    }
+    return ~crc;
+}
+
+static void check_crc32c(void)
+{
+    static const size_t sizes[] = {0, 1, 7, 8, 9, 63, 64, 65, 1000, 4095, 4096, 4097, 65539, 300007};
+    unsigned char zeros[32] = {0}, ones[32];
+    unsigned char *buf = malloc(300007 + 8);
+    uint32_t a, b;
+    size_t s, off;
+
+    // RFC 3720 B.4 and the usual check value
+    memset(ones, 0xFF, sizeof(ones));
+    check(crc32c_update(0, "123456789", 9) == 0xE3069283U, "CRC32C of \"123456789\"");
+    check(crc32c_update(0, zeros, 32) == 0x8A9136AAU, "CRC32C of 32 zero bytes");
+    check(crc32c_update(0, ones, 32) == 0x62A8AB43U, "CRC32C of 32 0xFF bytes");
+
+    rng_state = 0x9E3779B97F4A7C15ULL;
+    fill_random(buf, 300007 + 8);
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        for (off = 0; off < 8; off += 3)
+            check(crc32c_update(0, buf + off, sizes[s]) == crc32c_reference(buf + off, sizes[s]),
+                  "CRC32C against the bitwise reference");
+    }
+
+    a = crc32c_update(0, buf, 1000);
+    b = crc32c_update(0, buf + 1000, 70001);
+    check(crc32c_update(a, buf + 1000, 70001) == crc32c_reference(buf, 71001), "CRC32C continued over two blocks");
+    check(crc32c_combine(a, b, 70001) == crc32c_reference(buf, 71001), "CRC32C of two blocks combined");
+    free(buf);
+}
+
+#define ROTL(v, n) ((v) << (n) | (v) >> (32 - (n)))
+#define QR(a, b, c, d) \
+    (a += b, d ^= a, d = ROTL(d, 16), c += d, b ^= c, b = ROTL(b, 12), \
+     a += b, d ^= a, d = ROTL(d, 8), c += d, b ^= c, b = ROTL(b, 7))
+
+// One ChaCha20 block as RFC 8439 2.3 spells it out
+static void chacha20_reference(const unsigned char key[32], const unsigned char nonce[12], uint32_t counter,
+                               unsigned char out[64])
+{
+    uint32_t in[16], x[16];
+    int i;
+
+    in[0] = 0x61707865;
+    in[1] = 0x3320646e;
+    in[2] = 0x79622d32;
+    in[3] = 0x6b206574;
+    for (i = 0; i < 8; i++)
+        in[4 + i] = key[i * 4] | key[i * 4 + 1] << 8 | key[i * 4 + 2] << 16 | (uint32_t)key[i * 4 + 3] << 24;
+    in[12] = counter;
+    for (i = 0; i < 3; i++)
+        in[13 + i] = nonce[i * 4] | nonce[i * 4 + 1] << 8 | nonce[i * 4 + 2] << 16 | (uint32_t)nonce[i * 4 + 3] << 24;
+
+    memcpy(x, in, sizeof(x));
+    for (i = 0; i < 10; i++)
+    {
+        QR(x[0], x[4], x[8], x[12]);
+        QR(x[1], x[5], x[9], x[13]);
+        QR(x[2], x[6], x[10], x[14]);
+        QR(x[3], x[7], x[11], x[15]);
+        QR(x[0], x[5], x[10], x[15]);
+        QR(x[1], x[6], x[11], x[12]);
+        QR(x[2], x[7], x[8], x[13]);
+        QR(x[3], x[4], x[9], x[14]);
+    }
+    for (i = 0; i < 16; i++)
+    {
+        x[i] += in[i];
+        out[i * 4] = x[i];
+        out[i * 4 + 1] = x[i] >> 8;
+        out[i * 4 + 2] = x[i] >> 16;
+        out[i * 4 + 3] = x[i] >> 24;
+    }
+}
+
+static void check_aead(void)
+{
+    // RFC 8439 2.8.2
+    static const unsigned char nonce[12] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    static const unsigned char aad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    static const char plaintext[] = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                                    "for the future, sunscreen would be it.";
+    static const unsigned char ciphertext[114] = {
+        0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+        0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+        0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+        0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+        0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+        0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+        0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+        0x61, 0x16};
+    static const unsigned char tag[16] = {0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a,
+                                          0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91};
+    unsigned char key[32], data[114], got[16], block[64];
+    unsigned char *stream, *expect;
+    long size = 37 * 64 + 29, i;
+    int k;
+
+    for (k = 0; k < 32; k++)
+        key[k] = 0x80 + k;
+    memcpy(data, plaintext, sizeof(data));
+    aead_seal(key, nonce, aad, sizeof(aad), data, sizeof(data), got);
+    check(memcmp(data, ciphertext, sizeof(data)) == 0, "ChaCha20-Poly1305 RFC 8439 ciphertext");
+    check(memcmp(got, tag, sizeof(tag)) == 0, "ChaCha20-Poly1305 RFC 8439 tag");
+    check(aead_open(key, nonce, aad, sizeof(aad), data, sizeof(data), tag) == e_success &&
+              memcmp(data, plaintext, sizeof(data)) == 0,
+          "ChaCha20-Poly1305 RFC 8439 open");
+
+    got[0] ^= 1;
+    memcpy(data, ciphertext, sizeof(data));
+    check(aead_open(key, nonce, aad, sizeof(aad), data, sizeof(data), got) == e_failure &&
+              memcmp(data, ciphertext, sizeof(data)) == 0,
+          "ChaCha20-Poly1305 rejects a wrong tag, data untouched");
+
+    // Long enough for every width of core, and a tail
+    stream = calloc(size, 1);
+    expect = malloc(size);
+    chacha20_xor(key, nonce, 7, stream, size);
+    for (i = 0; i < size; i += 64)
+    {
+        chacha20_reference(key, nonce, 7 + i / 64, block);
+        memcpy(expect + i, block, size - i < 64 ? size - i : 64);
+    }
+    check(memcmp(stream, expect, size) == 0, "ChaCha20 keystream against the reference");
+    free(stream);
+    free(expect);
+}
+
+static void check_lz(void)
+{
+    // Four literals, an 8 byte match 4 back, then the last literal
+    static const unsigned char stream[] = {0x44, 'a', 'b', 'c', 'd', 0x04, 0x00, 0x10, 'e'};
+    static const long sizes[] = {0, 1, 15, 16, 1000, 65536, 65537, 300000};
+    unsigned char out[64];
+    unsigned char *src = malloc(300000), *packed = malloc(LZ_BOUND(300000)), *back = malloc(300000);
+    long n, s;
+    int kind;
+
+    n = lz_decompress(stream, sizeof(stream), out, sizeof(out));
+    check(n == 13 && memcmp(out, "abcdabcdabcde", 13) == 0, "LZ known stream");
+
+    rng_state = 0x2545F4914F6CDD1DULL;
+    for (kind = 0; kind < 3; kind++)
+    {
+        for (s = 0; s < (long)(sizeof(sizes) / sizeof(sizes[0])); s++)
+        {
+            if (kind == 0)
+                fill_random(src, sizes[s]);
+            else if (kind == 1)
+                fill_text(src, sizes[s]);
+            else
+                memset(src, 'z', sizes[s]);
+            n = lz_compress(src, sizes[s], packed, LZ_BOUND(sizes[s]));
+            check(n >= 0 && lz_decompress(packed, n, back, sizes[s]) == sizes[s] && memcmp(src, back, sizes[s]) == 0,
+                  kind == 0 ? "LZ round trip of random data" : kind == 1 ? "LZ round trip of text" : "LZ round trip of a run");
+        }
+    }
+    free(src);
+    free(packed);
+    free(back);
+}
+
+static void check_fec(void)
+{
+    unsigned char *stripe = malloc(FEC_STRIPE_SIZE), *damaged = malloc(FEC_STRIPE_SIZE);
+    int c, e;
+
+    rng_state = 0xD1B54A32D192ED03ULL;
+    fill_random(stripe, FEC_STRIPE_DATA);
+    fec_encode(stripe);
+    // Parity of this stripe as images have carried it since --fec came in
+    check(crc32c_update(0, stripe, FEC_STRIPE_SIZE) == 0x0BC8ADA7U, "Reed-Solomon parity of a known stripe");
+
+    // Codeword c is column c: 16 wrong bytes in every one of them is still all put right
+    memcpy(damaged, stripe, FEC_STRIPE_SIZE);
+    for (c = 0; c < FEC_DEPTH; c++)
+    {
+        for (e = 0; e < FEC_PARITY / 2; e++)
+            damaged[((c * 7 + e * 15) % FEC_N) * FEC_DEPTH + c] ^= 1 + (next_random() >> 57);
+    }
+    check(fec_decode(damaged) == FEC_DEPTH * FEC_PARITY / 2 && memcmp(damaged, stripe, FEC_STRIPE_SIZE) == 0,
+          "Reed-Solomon corrects 16 errors per codeword");
+
+    memcpy(damaged, stripe, FEC_STRIPE_SIZE);
+    for (e = 0; e <= FEC_PARITY / 2; e++)
+        damaged[e * 11 * FEC_DEPTH + 3] ^= 0x5A;
+    check(fec_decode(damaged) == -1, "Reed-Solomon reports 17 errors in a codeword");
+    free(stripe);
+    free(damaged);
+}
+
+static void check_kernels(void)
+{
+    static const char *names[] = {"avx2", "bmi2", "sse2", "scalar"};
+    static const int densities[] = {1, 2, 4};
+    unsigned char carrier[8 * 1031], dest[8 * 1031], expect[8 * 1031], data[1031], back[1031];
+    unsigned char bit[8], one = 0xA5;
+    const LsbKernel *kernel, *scalar;
+    int d, n, i;
+
+    // MSB first, one bit in the LSB of each carrier byte, the other bits left alone
+    memset(carrier, 0xF0, 8);
+    lsb_kernel_by_name("scalar", 1)->embed(bit, carrier, &one, 1);
+    for (i = 0; i < 8 && bit[i] == (0xF0 | (one >> (7 - i) & 1)); i++)
+        ;
+    check(i == 8, "LSB layout of one byte at 1 bit per carrier byte");
+
+    rng_state = 0x94D049BB133111EBULL;
+    fill_random(carrier, sizeof(carrier));
+    fill_random(data, sizeof(data));
+    for (d = 0; d < 3; d++)
+    {
+        scalar = lsb_kernel_by_name("scalar", densities[d]);
+        scalar->embed(expect, carrier, data, sizeof(data));
+        for (n = 0; n < 4; n++)
+        {
+            kernel = lsb_kernel_by_name(names[n], densities[d]);
+            if (kernel == NULL)
+                continue;
+            kernel->embed(dest, carrier, data, sizeof(data));
+            kernel->extract(back, dest, sizeof(data));
+            check(memcmp(dest, expect, LSB_CARRIER_SIZE(sizeof(data), densities[d])) == 0 &&
+                      memcmp(back, data, sizeof(data)) == 0,
+                  "LSB kernel against the scalar one");
+        }
+    }
+}
+
+// 24 bpp cover of random pixels, the same on every run
+static void make_cover(unsigned char *cover)
+{
+    static const unsigned char header[54] = {
+        'B', 'M', COVER_SIZE & 0xFF, COVER_SIZE >> 8 & 0xFF, COVER_SIZE >> 16 & 0xFF, 0, 0, 0, 0, 0, 54, 0, 0, 0,
+        40, 0, 0, 0, COVER_WIDTH & 0xFF, COVER_WIDTH >> 8, 0, 0, COVER_HEIGHT & 0xFF, COVER_HEIGHT >> 8, 0, 0,
+        1, 0, 24};
+
+    rng_state = 0xBF58476D1CE4E5B9ULL;
+    memcpy(cover, header, sizeof(header));
+    fill_random(cover + 54, COVER_SIZE - 54);
+}
+
+static void check_images(void)
+{
+    // Options and the CRC32C of the image they gave when this check was written
+    static const struct
+    {
+        int bits, compress, crc, fec;
+        uint32_t image_crc;
+        const char *what;
+    } formats[] = {
+        {1, 0, 1, 0, 0xCA554ED5U, "image at 1 bit"},
+        {2, 0, 1, 0, 0x95D867F8U, "image at 2 bits"},
+        {4, 0, 1, 0, 0xE97793B4U, "image at 4 bits"},
+        {1, 0, 0, 0, 0x74368852U, "image without checksum"},
+        {1, 1, 1, 0, 0x2AAB692CU, "compressed image"},
+        {2, 0, 1, 1, 0x0F9FD156U, "error corrected image"},
+    };
+    unsigned char key[STEGO_KEY_SIZE], wrong[STEGO_KEY_SIZE];
+    unsigned char *cover = malloc(COVER_SIZE), *image = malloc(COVER_SIZE);
+    unsigned char payload[PAYLOAD_SIZE], back[PAYLOAD_SIZE];
+    char extn[STEGO_MAX_EXTN + 1], what[96];
+    StegoOptions options;
+    size_t size;
+    unsigned f;
+    int scatter;
+
+    make_cover(cover);
+    rng_state = 0x9E3779B97F4A7C15ULL;
+    fill_text(payload, sizeof(payload));
+
+    for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+    {
+        stego_options_init(&options);
+        options.bits = formats[f].bits;
+        options.compress = formats[f].compress;
+        options.crc = formats[f].crc;
+        options.fec = formats[f].fec;
+        snprintf(what, sizeof(what), "%s, as written before", formats[f].what);
+        check(stego_encode_buffer(cover, COVER_SIZE, payload, sizeof(payload), ".txt", image, COVER_SIZE, &options) ==
+                      e_stego_ok &&
+                  crc32c_update(0, image, COVER_SIZE) == formats[f].image_crc,
+              what);
+        snprintf(what, sizeof(what), "%s, decoded", formats[f].what);
+        check(stego_decode_buffer(image, COVER_SIZE, back, sizeof(back), &size, extn, &options) == e_stego_ok &&
+                  size == sizeof(payload) && memcmp(back, payload, size) == 0 && strcmp(extn, ".txt") == 0,
+              what);
+    }
+
+    // A fresh nonce per image: sealed images can only go there and back
+    for (f = 0; f < STEGO_KEY_SIZE; f++)
+    {
+        key[f] = f * 37 + 1;
+        wrong[f] = key[f] ^ (f == 5);
+    }
+    for (scatter = 0; scatter < 2; scatter++)
+    {
+        stego_options_init(&options);
+        options.key = key;
+        options.scatter = scatter;
+        check(stego_encode_buffer(cover, COVER_SIZE, payload, sizeof(payload), ".txt", image, COVER_SIZE, &options) ==
+                      e_stego_ok &&
+                  stego_decode_buffer(image, COVER_SIZE, back, sizeof(back), &size, extn, &options) == e_stego_ok &&
+                  size == sizeof(payload) && memcmp(back, payload, size) == 0,
+              scatter ? "scattered image, decoded with its key" : "encrypted image, decoded with its key");
+        options.key = NULL;
+        options.scatter = 0;
+        check(stego_decode_buffer(image, COVER_SIZE, back, sizeof(back), &size, extn, &options) == e_stego_no_key,
+              "encrypted image refused without a key");
+        options.key = wrong;
+        check(stego_decode_buffer(image, COVER_SIZE, back, sizeof(back), &size, extn, &options) != e_stego_ok,
+              "encrypted image refused with a wrong key");
+    }
+    free(cover);
+    free(image);
+}
+
+int main(void)
+{
+    // The library stays silent: only failed checks are printed
+    check_crc32c();
+    check_aead();
+    check_lz();
+    check_fec();
+    check_kernels();
+    check_images();
+
+    printf("📦 %d checks: %d passed, %d failed (STEGO_KERNEL=%s)\n", checks, checks - failures, failures,
+           getenv("STEGO_KERNEL") ? getenv("STEGO_KERNEL") : "auto");
+    return failures ? 1 : 0;
+}
@@ -4,4 +4,66 @@
 /* Magic string to identify whether stegged or not */
 #define MAGIC_STRING "#*"
 
-#endif
\ No newline at end of file
+/*
+ * The 32-bit extension size field carries format flags above the size.
+ * Images from older encoders leave them 0, which reads as 1 bit per byte.
+ */
+#define EXTN_SIZE_MASK 0xFF
+#define DENSITY_SHIFT 8                     /* log2(bits per carrier byte) */
+#define DENSITY_MASK (0x3 << DENSITY_SHIFT)
+#define FLAG_COMPRESSED (1 << 10)           /* Data is a stream of frames */
+#define FLAG_CRC (1 << 11)                  /* Data is followed by a CRC32C */
+#define FLAG_ENCRYPTED (1 << 12)            /* Data is a stream of sealed frames */
+#define FLAG_PIXEL_LAYOUT (1 << 13)         /* Carrier from bfOffBits, no padding/alpha */
+#define FLAG_ARCHIVE (1 << 14)              /* Data is an archive of files */
+#define FLAG_STREAMED (1 << 15)             /* Size unknown when encoding: 0, the end frame closes the data */
+#define FLAG_SCATTERED (1 << 16)            /* Data in keyed block order over the carrier (see scatter.h) */
+#define FLAG_FEC (1 << 17)                  /* Data and CRC coded in Reed-Solomon stripes (see fec.h) */
+#define KNOWN_HEADER_FLAGS (DENSITY_MASK | FLAG_COMPRESSED | FLAG_CRC | FLAG_ENCRYPTED | FLAG_PIXEL_LAYOUT | \
+                            FLAG_ARCHIVE | FLAG_STREAMED | FLAG_SCATTERED | FLAG_FEC)
+
+/* Big-endian CRC32C of the embedded data bytes (frames included), at the data density */
+#define CRC_SIZE 4
+
+/*
+ * Compressed data: frames of a 4-byte big-endian header and its bytes,
+ * ended by a zero header. Bit 31 marks an LZ frame, the rest is the
+ * frame length; raw frames hold blocks that did not shrink. Every frame
+ * but the last holds LSB_PAYLOAD_BLOCK payload bytes, so a range decode
+ * steps over whole frames by their headers. A secret read from a pipe
+ * is always framed (FLAG_STREAMED): its size is not known until the end
+ * frame is written, so the size field holds 0.
+ */
+#define FRAME_HEADER_SIZE 4
+#define FRAME_COMPRESSED 0x80000000U
+#define FRAME_LENGTH_MASK 0x7FFFFFFFU
+
+/*
+ * Encrypted data: a random nonce prefix, then the frames above with a
+ * 16-byte Poly1305 tag after each one, the end frame included. Frame i
+ * is sealed under nonce prefix || i (big-endian), its header authenticated.
+ */
+#define NONCE_PREFIX_SIZE 8
+
+/*
+ * Archive data: the files back to back, then the table of contents (a
+ * 4-byte entry count, then per entry a 1-byte name length, the name and
+ * its 4-byte offset, size and CRC32C), then a trailer of the table's
+ * offset and CRC32C. All big-endian, offsets counted in data bytes; the
+ * extension is empty. Archives are never framed, so any entry can be
+ * seeked to.
+ */
+#define ARCHIVE_ENTRY_SIZE(name_len) (1 + (name_len) + 12)
+#define ARCHIVE_TRAILER_SIZE 8
+
+/*
+ * Coded data: everything from the first data byte through the CRC goes
+ * through Reed-Solomon stripes of FEC_STRIPE_DATA bytes, each embedded
+ * with its parity rows as FEC_STRIPE_SIZE bytes, the last one padded
+ * with zeros. A range cannot be seeked to through the stripes.
+ */
+
+/* File name standing for stdin or stdout: read or written front to back, never seeked */
+#define STREAM_NAME "-"
+
+#endif
@@ -0,0 +1,165 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - CRC32C checksum
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "crc32c.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CRC32C_X86 1
+#endif
+
+#define CRC32C_POLY 0x82F63B78U /* Reflected Castagnoli polynomial */
+
+// Below this the three-way split costs more than it saves
+#define CRC32C_LANES_MIN 4096
+
+static uint32_t table[8][256];
+static uint32_t x2n_table[32]; /* x^(2^k) mod P */
+static int use_sse42;
+
+// Slicing-by-8: one table lookup per input byte, eight independent per step
+static uint32_t update_table(uint32_t crc, const unsigned char *p, size_t size)
+{
+    uint32_t lo, hi;
+
+    while (size >= 8)
+    {
+        memcpy(&lo, p, 4);
+        memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+        crc = table[7][lo & 0xFF] ^ table[6][(lo >> 8) & 0xFF] ^ table[5][(lo >> 16) & 0xFF] ^ table[4][lo >> 24] ^
+              table[3][hi & 0xFF] ^ table[2][(hi >> 8) & 0xFF] ^ table[1][(hi >> 16) & 0xFF] ^ table[0][hi >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0)
+        crc = table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+// a * b modulo P, both as reflected polynomials
+static uint32_t multmodp(uint32_t a, uint32_t b)
+{
+    uint32_t m = 1U << 31, p = 0;
+
+    for (;;)
+    {
+        if (a & m)
+        {
+            p ^= b;
+            if ((a & (m - 1)) == 0)
+                break;
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+    }
+    return p;
+}
+
+// x^(8 * size) mod P: the shift that appending size zero bytes applies
+static uint32_t x8nmodp(size_t size)
+{
+    uint32_t p = 1U << 31;
+    unsigned k = 3;
+
+    while (size)
+    {
+        if (size & 1)
+            p = multmodp(x2n_table[k & 31], p);
+        size >>= 1;
+        k++;
+    }
+    return p;
+}
+
+uint32_t crc32c_combine(uint32_t crc_a, uint32_t crc_b, size_t size_b)
+{
+    return multmodp(x8nmodp(size_b), crc_a) ^ crc_b;
+}
+
+#ifdef CRC32C_X86
+
+// One crc32 instruction per 8 bytes; latency bound, so big inputs run three
+// independent lanes side by side and stitch them together with combine
+__attribute__((target("sse4.2"))) static uint32_t update_sse42(uint32_t crc, const unsigned char *p, size_t size)
+{
+    uint64_t c0 = crc, c1 = 0xFFFFFFFFU, c2 = 0xFFFFFFFFU, v0, v1, v2;
+    size_t lane, i;
+
+    if (size >= CRC32C_LANES_MIN)
+    {
+        lane = size / 24 * 8;
+        for (i = 0; i < lane; i += 8)
+        {
+            memcpy(&v0, p + i, 8);
+            memcpy(&v1, p + lane + i, 8);
+            memcpy(&v2, p + 2 * lane + i, 8);
+            c0 = _mm_crc32_u64(c0, v0);
+            c1 = _mm_crc32_u64(c1, v1);
+            c2 = _mm_crc32_u64(c2, v2);
+        }
+        // Lanes 1 and 2 started from the all-ones state of a fresh CRC
+        c0 = ~crc32c_combine(~(uint32_t)c0, ~(uint32_t)c1, lane);
+        c0 = ~crc32c_combine(~(uint32_t)c0, ~(uint32_t)c2, lane);
+        p += 3 * lane;
+        size -= 3 * lane;
+    }
+
+    while (size >= 8)
+    {
+        memcpy(&v0, p, 8);
+        c0 = _mm_crc32_u64(c0, v0);
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0)
+        c0 = _mm_crc32_u8((uint32_t)c0, *p++);
+    return (uint32_t)c0;
+}
+
+#endif
+
+uint32_t crc32c_update(uint32_t crc, const void *data, size_t size)
+{
+    crc = ~crc;
+#ifdef CRC32C_X86
+    if (use_sse42)
+        return ~update_sse42(crc, data, size);
+#endif
+    return ~update_table(crc, data, size);
+}
+
+// Build the tables and pick the instruction once at startup
+__attribute__((constructor)) static void crc32c_init(void)
+{
+    uint32_t crc;
+    int i, j;
+
+    for (i = 0; i < 256; i++)
+    {
+        crc = i;
+        for (j = 0; j < 8; j++)
+            crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+        table[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++)
+    {
+        for (j = 1; j < 8; j++)
+            table[j][i] = (table[j - 1][i] >> 8) ^ table[0][table[j - 1][i] & 0xFF];
+    }
+
+    x2n_table[0] = 1U << 30; /* x^1 */
+    for (i = 1; i < 32; i++)
+        x2n_table[i] = multmodp(x2n_table[i - 1], x2n_table[i - 1]);
+
+#ifdef CRC32C_X86
+    // STEGO_KERNEL=scalar keeps to the tables
+    __builtin_cpu_init();
+    use_sse42 = __builtin_cpu_supports("sse4.2") &&
+                (getenv("STEGO_KERNEL") == NULL || strcmp(getenv("STEGO_KERNEL"), "scalar") != 0);
+#endif
+}
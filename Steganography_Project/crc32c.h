@@ -0,0 +1,19 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * CRC32C (Castagnoli), zlib-style: start with 0, feed blocks in order.
+ * Uses the SSE4.2 crc32 instruction when the CPU has it, a
+ * slicing-by-8 table otherwise or under STEGO_KERNEL=scalar.
+ */
+
+/* Continue crc over size bytes of data */
+uint32_t crc32c_update(uint32_t crc, const void *data, size_t size);
+
+/* CRC of A followed by B, from crc_a, crc_b and the length of B */
+uint32_t crc32c_combine(uint32_t crc_a, uint32_t crc_b, size_t size_b);
+
+#endif
@@ -0,0 +1,855 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - daemon mode over a Unix domain socket
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "daemon.h"
+#include "stego_log.h"
+#include "common.h"
+
+#define DAEMON_EVENTS 64
+
+// One loaded cover: the cache holds a reference, and so does every request using it
+typedef struct
+{
+    char *path;
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime;
+    unsigned char *data;
+    int refs;
+    unsigned long used; /* Cache clock at the last hit */
+} Cover;
+
+typedef struct
+{
+    Cover *slots[DAEMON_MAX_COVERS];
+    unsigned long clock;
+    long hits;
+    long loads;
+    pthread_mutex_t lock;
+} CoverCache;
+
+// A client, non-blocking, and what has arrived of its next request
+typedef struct Conn
+{
+    int fd;
+    struct Conn *next;      /* In the ready queue */
+    struct Conn *prev_open; /* In the list of open connections */
+    struct Conn *next_open;
+    char line[DAEMON_MAX_LINE]; /* Last request line, kept while a PUT payload comes in */
+    unsigned char *body;        /* That payload, body_got of body_size bytes in; NULL between requests */
+    size_t body_size;
+    size_t body_got;
+    int replying;                  /* A reply the client's socket had no room for is still going out: */
+    char head[MAX_ERROR_MSG + 64]; /* its header, head_sent of head_len out */
+    size_t head_len;
+    size_t head_sent;
+    unsigned char *out; /* and its body, out_sent of out_len out, in a buffer traded with a worker */
+    size_t out_cap;
+    size_t out_len;
+    size_t out_sent;
+    size_t len; /* Bytes read past the last request line */
+    char buf[DAEMON_MAX_LINE];
+} Conn;
+
+// Connections with a request waiting, handed from the epoll loop to the workers
+typedef struct
+{
+    Conn *head;
+    Conn *tail;
+    int stop;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} ConnQueue;
+
+typedef struct
+{
+    int epfd;
+    StegoOptions options;
+    CoverCache covers;
+    ConnQueue queue;
+    Conn *open; /* Every client, hung up on at exit */
+    pthread_mutex_t open_lock;
+    long requests; /* Served so far, counted atomically */
+    long failed;
+} Daemon;
+
+// A worker's buffers, kept (with their pages faulted in) from one request to the next
+typedef struct
+{
+    Daemon *daemon;
+    pthread_t tid;
+    unsigned char *in; /* Secret of an ENCODE */
+    size_t in_cap;
+    unsigned char *out; /* Image or payload produced */
+    size_t out_cap;
+    size_t out_len;
+} Worker;
+
+static volatile sig_atomic_t stopping;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stopping = 1;
+}
+
+// Grow *buf to at least size bytes, keeping its contents
+static Status reserve(unsigned char **buf, size_t *cap, size_t size)
+{
+    unsigned char *grown;
+    size_t want = *cap * 2 > size ? *cap * 2 : size;
+
+    if (size <= *cap)
+        return e_success;
+    grown = realloc(*buf, want);
+    if (grown == NULL)
+        return e_failure;
+    *buf = grown;
+    *cap = want;
+    return e_success;
+}
+
+// Read all of fd, size bytes, into buf
+static Status read_all(int fd, unsigned char *buf, size_t size)
+{
+    size_t done = 0;
+    ssize_t n;
+
+    while (done < size)
+    {
+        n = read(fd, buf + done, size - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return e_failure;
+        done += n;
+    }
+    return e_success;
+}
+
+// Write data[*done, size) to a client as far as its socket takes it: send() so a vanished client is no SIGPIPE
+// Returns 1 once all is written, 0 when the socket is full, -1 when the client is gone
+static int send_some(int fd, const void *data, size_t size, size_t *done)
+{
+    ssize_t n;
+
+    while (*done < size)
+    {
+        n = send(fd, (const char *)data + *done, size - *done, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+        if (n < 0)
+            return -1;
+        *done += n;
+    }
+    return 1;
+}
+
+// Write over an existing file and cut it to size after: truncating first has the file system
+// allocate every block again (and ext4 flush it on close), many times the cost of the copy
+static StegoError write_file(const char *path, const unsigned char *data, size_t size)
+{
+    size_t done = 0;
+    ssize_t n;
+    int written, fd = open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+
+    if (fd < 0)
+    {
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", path, strerror(errno));
+        return e_stego_io;
+    }
+    while (done < size)
+    {
+        n = write(fd, data + done, size - done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            break;
+        done += n;
+    }
+    written = done == size && ftruncate(fd, size) == 0;
+    if (close(fd) != 0 || !written)
+    {
+        stego_error("ERROR:❌ Unable to write %s: %s\n", path, strerror(errno));
+        return e_stego_io;
+    }
+    return e_success;
+}
+
+static void cover_free(Cover *cover)
+{
+    free(cover->data);
+    free(cover->path);
+    free(cover);
+}
+
+// Drop one reference, the last one frees the cover; called with the cache locked
+static void cover_put_locked(Cover *cover)
+{
+    if (--cover->refs == 0)
+        cover_free(cover);
+}
+
+static void cover_put(CoverCache *cache, Cover *cover)
+{
+    pthread_mutex_lock(&cache->lock);
+    cover_put_locked(cover);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// Read the whole file at path into a new cover
+static Cover *load_cover(const char *path, StegoError *err)
+{
+    struct stat st;
+    Cover *cover;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    *err = e_stego_io;
+    if (fd < 0)
+    {
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    cover = calloc(1, sizeof(*cover));
+    if (cover == NULL || fstat(fd, &st) != 0 || (cover->path = strdup(path)) == NULL ||
+        (cover->data = malloc(st.st_size > 0 ? st.st_size : 1)) == NULL)
+    {
+        *err = e_stego_no_memory;
+    }
+    else if (read_all(fd, cover->data, st.st_size) == e_failure)
+    {
+        stego_error("ERROR:❌ Unable to read %s\n", path);
+    }
+    else
+    {
+        close(fd);
+        cover->dev = st.st_dev;
+        cover->ino = st.st_ino;
+        cover->size = st.st_size;
+        cover->mtime = st.st_mtim;
+        *err = e_stego_ok;
+        return cover;
+    }
+    close(fd);
+    if (cover != NULL)
+        cover_free(cover);
+    return NULL;
+}
+
+// The loaded cover at path, read again when the file changed since it was loaded
+static Cover *cover_get(CoverCache *cache, const char *path, StegoError *err)
+{
+    struct stat st;
+    Cover *cover;
+    int i, victim = -1;
+
+    if (stat(path, &st) != 0)
+    {
+        *err = e_stego_io;
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    for (i = 0; i < DAEMON_MAX_COVERS; i++)
+    {
+        cover = cache->slots[i];
+        if (cover != NULL && cover->ino == st.st_ino && cover->dev == st.st_dev && cover->size == st.st_size &&
+            cover->mtime.tv_sec == st.st_mtim.tv_sec && cover->mtime.tv_nsec == st.st_mtim.tv_nsec &&
+            strcmp(cover->path, path) == 0)
+        {
+            cover->refs++;
+            cover->used = ++cache->clock;
+            cache->hits++;
+            pthread_mutex_unlock(&cache->lock);
+            return cover;
+        }
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    // Read outside the lock, so other workers' hits do not wait on the disk
+    cover = load_cover(path, err);
+    if (cover == NULL)
+        return NULL;
+
+    // An older copy of the same path gives up its slot, else an empty one, else the least recently used
+    pthread_mutex_lock(&cache->lock);
+    for (i = 0; i < DAEMON_MAX_COVERS; i++)
+    {
+        if (cache->slots[i] != NULL && strcmp(cache->slots[i]->path, path) == 0)
+        {
+            victim = i;
+            break;
+        }
+        if (victim < 0 || (cache->slots[victim] != NULL &&
+                           (cache->slots[i] == NULL || cache->slots[i]->used < cache->slots[victim]->used)))
+            victim = i;
+    }
+    if (cache->slots[victim] != NULL)
+        cover_put_locked(cache->slots[victim]);
+    cache->slots[victim] = cover;
+    cover->refs = 2;
+    cover->used = ++cache->clock;
+    cache->loads++;
+    pthread_mutex_unlock(&cache->lock);
+    return cover;
+}
+
+static void queue_push(ConnQueue *queue, Conn *conn)
+{
+    pthread_mutex_lock(&queue->lock);
+    conn->next = NULL;
+    if (queue->tail != NULL)
+        queue->tail->next = conn;
+    else
+        queue->head = conn;
+    queue->tail = conn;
+    pthread_cond_signal(&queue->ready);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Next connection with a request waiting, NULL once the daemon stops
+static Conn *queue_pop(ConnQueue *queue)
+{
+    Conn *conn;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->head == NULL && !queue->stop)
+        pthread_cond_wait(&queue->ready, &queue->lock);
+    conn = queue->head;
+    if (conn != NULL)
+    {
+        queue->head = conn->next;
+        if (queue->head == NULL)
+            queue->tail = NULL;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return conn;
+}
+
+static void conn_close(Daemon *daemon, Conn *conn)
+{
+    pthread_mutex_lock(&daemon->open_lock);
+    if (conn->prev_open != NULL)
+        conn->prev_open->next_open = conn->next_open;
+    else
+        daemon->open = conn->next_open;
+    if (conn->next_open != NULL)
+        conn->next_open->prev_open = conn->prev_open;
+    pthread_mutex_unlock(&daemon->open_lock);
+    close(conn->fd);
+    free(conn->body);
+    free(conn->out);
+    free(conn);
+}
+
+// Next request line of conn into conn->line, NUL terminated, from what the socket has now
+// Returns 1, 0 when the line is not all in yet, -1 when the client closed, failed or sent an overlong line
+static int read_line(Conn *conn)
+{
+    char *nl;
+    size_t used;
+    ssize_t n;
+
+    while ((nl = memchr(conn->buf, '\n', conn->len)) == NULL)
+    {
+        if (conn->len == sizeof(conn->buf))
+            return -1;
+        n = read(conn->fd, conn->buf + conn->len, sizeof(conn->buf) - conn->len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+        if (n <= 0)
+            return -1;
+        conn->len += n;
+    }
+    used = nl - conn->buf + 1;
+    memcpy(conn->line, conn->buf, used - 1);
+    conn->line[used - 1] = '\0';
+    conn->len -= used;
+    memmove(conn->buf, conn->buf + used, conn->len);
+    return 1;
+}
+
+// More of the PUT payload from what the socket has now
+// Returns 1 once it is complete, 0 while more is to come, -1 when the client closed or failed
+static int read_body(Conn *conn)
+{
+    ssize_t n;
+
+    while (conn->body_got < conn->body_size)
+    {
+        n = read(conn->fd, conn->body + conn->body_got, conn->body_size - conn->body_got);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+        if (n <= 0)
+            return -1;
+        conn->body_got += n;
+    }
+    return 1;
+}
+
+// More of the reply in conn->head and conn->out
+// Returns 1 once it is all out, 0 while the client's socket is full, -1 when the client is gone
+static int send_rest(Conn *conn)
+{
+    int ret = send_some(conn->fd, conn->head, conn->head_len, &conn->head_sent);
+
+    if (ret > 0)
+        ret = send_some(conn->fd, conn->out, conn->out_len, &conn->out_sent);
+    conn->replying = ret == 0;
+    return ret;
+}
+
+// Send conn->head and w->out[0, w->out_len) as far as the client's socket takes them; what is left goes
+// out from the Conn, the worker trading its buffer for the Conn's rather than copying the image
+// Returns -1 when the client is gone
+static int send_reply(Worker *w, Conn *conn)
+{
+    unsigned char *spare = conn->out;
+    size_t spare_cap = conn->out_cap;
+    int ret;
+
+    conn->head_len = strlen(conn->head);
+    conn->head_sent = conn->out_sent = 0;
+    conn->out = w->out;
+    conn->out_cap = w->out_cap;
+    conn->out_len = w->out_len;
+    ret = send_rest(conn);
+    if (ret != 0)
+    {
+        conn->out = spare;
+        conn->out_cap = spare_cap;
+        conn->out_len = 0;
+        return ret;
+    }
+    w->out = spare;
+    w->out_cap = spare_cap;
+    return 1;
+}
+
+// Collect a PUT payload that did not come along with its line: what did, then the socket
+static Status start_body(Conn *conn, size_t size)
+{
+    conn->body = malloc(size);
+    if (conn->body == NULL)
+        return e_failure;
+    memcpy(conn->body, conn->buf, conn->len);
+    conn->body_size = size;
+    conn->body_got = conn->len;
+    conn->len = 0;
+    return e_success;
+}
+
+// Hide payload[0, size) in the cover at cover_path, into the file stego or, for "-", w->out
+static StegoError encode_request(Worker *w, const char *cover_path, const unsigned char *payload, size_t size,
+                                 const char *extn, const char *stego)
+{
+    StegoError err;
+    Cover *cover = cover_get(&w->daemon->covers, cover_path, &err);
+
+    if (cover == NULL)
+        return err;
+    if (reserve(&w->out, &w->out_cap, cover->size) == e_failure)
+        err = e_stego_no_memory;
+    else
+        err = stego_encode_buffer(cover->data, cover->size, payload, size, extn, w->out, cover->size,
+                                  &w->daemon->options);
+    w->out_len = cover->size;
+    cover_put(&w->daemon->covers, cover);
+
+    if (err == e_stego_ok && strcmp(stego, STREAM_NAME) != 0)
+    {
+        err = write_file(stego, w->out, w->out_len);
+        w->out_len = 0;
+    }
+    return err;
+}
+
+// Sink of a decode: append to the worker's output buffer
+static int out_sink(void *user, const void *data, size_t size)
+{
+    Worker *w = user;
+
+    if (reserve(&w->out, &w->out_cap, w->out_len + size) == e_failure)
+        return 1;
+    memcpy(w->out + w->out_len, data, size);
+    w->out_len += size;
+    return 0;
+}
+
+// Recover the payload of stego into w->out, then the file output + extension unless output is "-"
+static StegoError decode_request(Worker *w, const char *stego, const char *output, char extn[STEGO_MAX_EXTN + 1])
+{
+    char name[DAEMON_MAX_LINE + STEGO_MAX_EXTN];
+    struct stat st;
+    StegoError err;
+    void *map;
+    int fd = open(stego, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0 ||
+        (map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+    {
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", stego, strerror(errno));
+        if (fd >= 0)
+            close(fd);
+        return e_stego_io;
+    }
+    close(fd);
+
+    // Only the pages holding the header and payload are ever touched
+    err = stego_decode_to_sink(map, st.st_size, out_sink, w, extn, &w->daemon->options);
+    munmap(map, st.st_size);
+    if (err == e_stego_sink_failed)
+        err = e_stego_no_memory;
+
+    if (err == e_stego_ok && strcmp(output, STREAM_NAME) != 0)
+    {
+        snprintf(name, sizeof(name), "%s%s", output, extn);
+        err = write_file(name, w->out, w->out_len);
+        w->out_len = 0;
+    }
+    return err;
+}
+
+// Serve the request in conn->line, or for a PUT whose payload is still coming, start collecting it
+// Returns -1 when the connection can no longer be followed
+static int serve_request(Worker *w, Conn *conn)
+{
+    char line[DAEMON_MAX_LINE];
+    char *field[6], *save, *token, *end;
+    char extn[STEGO_MAX_EXTN + 1] = "";
+    const char *dot, *message;
+    StegoError err = e_stego_bad_args;
+    long size;
+    int n = 0, lost = 0;
+    struct stat st;
+    int fd;
+
+    stego_reset_error();
+    w->out_len = 0;
+    strcpy(line, conn->line);
+    for (token = strtok_r(line, " \t\r", &save); token != NULL && n < 6; token = strtok_r(NULL, " \t\r", &save))
+        field[n++] = token;
+
+    if (n == 4 && strcmp(field[0], "ENCODE") == 0)
+    {
+        // The secret's extension is recorded, as on the command line
+        dot = strrchr(field[2], '.');
+        if (dot != NULL && strchr(dot, '/') == NULL && strlen(dot) <= STEGO_MAX_EXTN)
+            strcpy(extn, dot);
+        fd = open(field[2], O_RDONLY | O_CLOEXEC);
+        if (fd < 0 || fstat(fd, &st) != 0)
+        {
+            err = e_stego_io;
+            stego_error("ERROR:❌ Unable to open file %s: %s\n", field[2], strerror(errno));
+        }
+        else if (reserve(&w->in, &w->in_cap, st.st_size) == e_failure)
+        {
+            err = e_stego_no_memory;
+        }
+        else if (read_all(fd, w->in, st.st_size) == e_failure)
+        {
+            err = e_stego_io;
+            stego_error("ERROR:❌ Unable to read %s\n", field[2]);
+        }
+        else
+        {
+            err = encode_request(w, field[1], w->in, st.st_size, extn, field[3]);
+        }
+        if (fd >= 0)
+            close(fd);
+    }
+    else if ((n == 4 || n == 5) && strcmp(field[0], "PUT") == 0)
+    {
+        // Without a valid size the payload cannot be told from the next request: hang up after replying
+        size = strtol(field[3], &end, 10);
+        if (*end != '\0' || size < 0 || size > DAEMON_MAX_PAYLOAD || (n == 5 && strlen(field[4]) > STEGO_MAX_EXTN))
+        {
+            stego_error("ERROR:❌ PUT expects a size up to %ld and an extension of up to %d characters\n",
+                        DAEMON_MAX_PAYLOAD, STEGO_MAX_EXTN);
+            lost = 1;
+        }
+        else if (conn->body == NULL && conn->len < (size_t)size)
+        {
+            if (start_body(conn, size) == e_success)
+                return 1;
+            err = e_stego_no_memory;
+            lost = 1;
+        }
+        else
+        {
+            // A payload that came along with its line is encoded straight from the read buffer
+            if (n == 5)
+                strcpy(extn, field[4]);
+            if (conn->body != NULL)
+            {
+                err = encode_request(w, field[1], conn->body, size, extn, field[2]);
+                free(conn->body);
+                conn->body = NULL;
+            }
+            else
+            {
+                err = encode_request(w, field[1], (unsigned char *)conn->buf, size, extn, field[2]);
+                conn->len -= size;
+                memmove(conn->buf, conn->buf + size, conn->len);
+            }
+        }
+    }
+    else if (n == 3 && strcmp(field[0], "DECODE") == 0)
+    {
+        err = decode_request(w, field[1], field[2], extn);
+    }
+    else
+    {
+        stego_error("ERROR:❌ Expected ENCODE <cover> <secret> <stego>, PUT <cover> <stego> <size> [extn] "
+                    "or DECODE <stego> <output>\n");
+    }
+
+    __atomic_fetch_add(&w->daemon->requests, 1, __ATOMIC_RELAXED);
+    if (err != e_stego_ok)
+    {
+        __atomic_fetch_add(&w->daemon->failed, 1, __ATOMIC_RELAXED);
+        message = *stego_first_error() ? stego_first_error() : stego_strerror(err);
+        snprintf(conn->head, sizeof(conn->head), "ERR %d %s\n", err, message);
+        w->out_len = 0;
+        return send_reply(w, conn) < 0 || lost ? -1 : 1;
+    }
+
+    snprintf(conn->head, sizeof(conn->head), "OK %zu %s\n", w->out_len, extn[0] ? extn : "-");
+    return send_reply(w, conn);
+}
+
+// Worker: serve every request a ready connection has buffered, then hand it back to epoll
+// The socket is never waited on here: a request not all in yet, or a reply not all out, stays in the
+// Conn until epoll reports the client ready again, and no request is read while a reply is kept
+static void *daemon_worker(void *arg)
+{
+    Worker *w = arg;
+    Daemon *daemon = w->daemon;
+    struct epoll_event ev;
+    Conn *conn;
+    int ret;
+
+    stego_set_quiet(1);
+    while ((conn = queue_pop(&daemon->queue)) != NULL)
+    {
+        do
+        {
+            if (conn->replying)
+                ret = send_rest(conn);
+            else if ((ret = conn->body != NULL ? read_body(conn) : read_line(conn)) > 0)
+                ret = serve_request(w, conn);
+        } while (ret > 0 && (conn->replying || conn->len > 0 || conn->body != NULL));
+
+        ev.events = (conn->replying ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+        ev.data.ptr = conn;
+        if (ret < 0 || epoll_ctl(daemon->epfd, EPOLL_CTL_MOD, conn->fd, &ev) != 0)
+            conn_close(daemon, conn);
+    }
+    return NULL;
+}
+
+// Bind socket_path, taking over a socket file that nobody listens on any more
+static int open_socket(const char *socket_path)
+{
+    struct sockaddr_un addr;
+    struct stat st;
+    int fd;
+
+    if (strlen(socket_path) >= sizeof(addr.sun_path))
+    {
+        fprintf(stderr, "ERROR:❌ Socket path %s is too long\n", socket_path);
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        perror("socket");
+        return -1;
+    }
+    if (stat(socket_path, &st) == 0 && S_ISSOCK(st.st_mode))
+    {
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+        {
+            fprintf(stderr, "ERROR:❌ A daemon already listens on %s\n", socket_path);
+            close(fd);
+            return -1;
+        }
+        unlink(socket_path);
+    }
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0)
+    {
+        fprintf(stderr, "ERROR:❌ Unable to listen on %s: %s\n", socket_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+Status run_daemon(const char *socket_path, int workers, const StegoOptions *options)
+{
+    struct epoll_event ev, events[DAEMON_EVENTS];
+    struct sigaction sa;
+    sigset_t block, old;
+    Daemon daemon;
+    Worker *pool;
+    Conn *conn;
+    int listen_fd, fd, i, n, started;
+
+    listen_fd = open_socket(socket_path);
+    if (listen_fd < 0)
+        return e_failure;
+
+    memset(&daemon, 0, sizeof(daemon));
+    daemon.options = *options;
+    // The workers are the parallelism: every request runs on one thread
+    daemon.options.threads = 1;
+    daemon.options.pipeline = 0;
+    daemon.options.stats = NULL;
+    daemon.options.range_offset = daemon.options.range_length = 0;
+    pthread_mutex_init(&daemon.covers.lock, NULL);
+    pthread_mutex_init(&daemon.queue.lock, NULL);
+    pthread_mutex_init(&daemon.open_lock, NULL);
+    pthread_cond_init(&daemon.queue.ready, NULL);
+
+    daemon.epfd = epoll_create1(EPOLL_CLOEXEC);
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (daemon.epfd < 0 || epoll_ctl(daemon.epfd, EPOLL_CTL_ADD, listen_fd, &ev) != 0)
+    {
+        perror("epoll");
+        close(listen_fd);
+        unlink(socket_path);
+        return e_failure;
+    }
+
+    // Workers never take SIGINT or SIGTERM: they must interrupt epoll_wait on this thread
+    sigemptyset(&block);
+    sigaddset(&block, SIGINT);
+    sigaddset(&block, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &block, &old);
+    if (workers < 1)
+        workers = 1;
+    pool = calloc(workers, sizeof(Worker));
+    for (started = 0; pool != NULL && started < workers; started++)
+    {
+        pool[started].daemon = &daemon;
+        if (pthread_create(&pool[started].tid, NULL, daemon_worker, &pool[started]) != 0)
+            break;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    printf("------------------------------------------------\n");
+    printf("    INFO: ## Daemon on %s with %d workers ## \n", socket_path, started);
+    printf("------------------------------------------------\n");
+    fflush(stdout);
+
+    while (started > 0 && !stopping)
+    {
+        n = epoll_wait(daemon.epfd, events, DAEMON_EVENTS, -1);
+        for (i = 0; i < n; i++)
+        {
+            if (events[i].data.ptr != NULL)
+            {
+                queue_push(&daemon.queue, events[i].data.ptr);
+                continue;
+            }
+
+            // A new client: watched one request at a time, re-armed by the worker that served it
+            fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (fd < 0)
+                continue;
+            conn = malloc(sizeof(*conn));
+            if (conn == NULL)
+            {
+                close(fd);
+                continue;
+            }
+            conn->fd = fd;
+            conn->body = NULL;
+            conn->replying = 0;
+            conn->out = NULL;
+            conn->out_cap = 0;
+            conn->len = 0;
+            conn->prev_open = NULL;
+            pthread_mutex_lock(&daemon.open_lock);
+            conn->next_open = daemon.open;
+            if (daemon.open != NULL)
+                daemon.open->prev_open = conn;
+            daemon.open = conn;
+            pthread_mutex_unlock(&daemon.open_lock);
+            ev.events = EPOLLIN | EPOLLONESHOT;
+            ev.data.ptr = conn;
+            if (epoll_ctl(daemon.epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+                conn_close(&daemon, conn);
+        }
+    }
+
+    // Requests being served run to the end; no worker waits on a client, so they all finish soon,
+    // then whoever is still connected is hung up on
+    pthread_mutex_lock(&daemon.queue.lock);
+    daemon.queue.stop = 1;
+    pthread_cond_broadcast(&daemon.queue.ready);
+    pthread_mutex_unlock(&daemon.queue.lock);
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(pool[i].tid, NULL);
+        free(pool[i].in);
+        free(pool[i].out);
+    }
+    while (daemon.open != NULL)
+        conn_close(&daemon, daemon.open);
+    close(listen_fd);
+    close(daemon.epfd);
+    unlink(socket_path);
+
+    printf("--------------------------------------------------\n");
+    printf("📦 %ld requests: %ld ok, %ld failed\n", daemon.requests, daemon.requests - daemon.failed, daemon.failed);
+    printf("📦 Covers: %ld loaded, %ld requests served from memory\n", daemon.covers.loads, daemon.covers.hits);
+    printf("--------------------------------------------------\n");
+
+    for (i = 0; i < DAEMON_MAX_COVERS; i++)
+    {
+        if (daemon.covers.slots[i] != NULL)
+            cover_put_locked(daemon.covers.slots[i]);
+    }
+    pthread_mutex_destroy(&daemon.covers.lock);
+    pthread_mutex_destroy(&daemon.queue.lock);
+    pthread_mutex_destroy(&daemon.open_lock);
+    pthread_cond_destroy(&daemon.queue.ready);
+    free(pool);
+    return started > 0 ? e_success : e_failure;
+}
@@ -0,0 +1,33 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include "types.h" // Contains user defined types
+#include "stego.h"
+
+/*
+ * Daemon mode
+ * Listens on a Unix domain socket and serves encode/decode requests on a
+ * pool of worker threads. Covers stay loaded between requests (reloaded
+ * once their size or mtime changes), and each worker keeps its image
+ * buffers, so a request costs no process start, no cover read and no page
+ * faults. Clients are never waited on: a slow one holds no worker, and a
+ * stop is not held up by it. A request is one line of whitespace separated
+ * fields, paths relative to the daemon's working directory:
+ *   ENCODE <cover.bmp> <secret> <stego.bmp|->     encode a file
+ *   PUT <cover.bmp> <stego.bmp|-> <size> [extn]   encode the size bytes after the line
+ *   DECODE <stego.bmp> <output_name|->            decode, output_name gets the extension
+ * The reply is "OK <size> <extn|->\n" and size bytes, the image or payload
+ * asked for with "-" (0 when written to a file), or "ERR <code> <message>\n"
+ * with a StegoError code. A connection carries any number of requests,
+ * answered in order. The daemon's -k, -z, -K, --no-crc, --scatter and
+ * --fec apply to every encode, its key to every decode.
+ */
+
+#define DAEMON_MAX_COVERS 64           /* Covers kept loaded, least recently used dropped first */
+#define DAEMON_MAX_LINE 4096           /* Longest request line */
+#define DAEMON_MAX_PAYLOAD (256L << 20) /* Largest PUT payload */
+
+/* Serve requests on socket_path with workers threads until SIGINT or SIGTERM */
+Status run_daemon(const char *socket_path, int workers, const StegoOptions *options);
+
+#endif
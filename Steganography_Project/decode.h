@@ -2,6 +2,9 @@
 #define DECODE_H
 #include <stdio.h>
 #include "types.h" // Contains user defined types
+#include "lsb_engine.h"
+#include "stego.h"
+#include "stego_stats.h"
 
 /*
  * Structure to store information required for
@@ -13,13 +16,14 @@
 #define MAX_SECRET_BUF_SIZE 1
 #define MAX_IMAGE_BUF_SIZE (MAX_SECRET_BUF_SIZE * 8)
 #define MAX_FILE_SUFFIX 4
+#define MAX_SECRET_FNAME 4096
 
 typedef struct _DeodeInfo
 {
     char *magic_string;
-    char secret_fname[50];
+    char secret_fname[MAX_SECRET_FNAME];
     FILE *fptr_secret;
-    char extn_secret_file[MAX_FILE_SUFFIX];
+    char extn_secret_file[MAX_FILE_SUFFIX + 1];
     // char secret_data[MAX_SECRET_BUF_SIZE];
 
     int secret_file_extn_size;
@@ -29,6 +33,52 @@ typedef struct _DeodeInfo
     char *stego_image_fname;
     FILE *fptr_stego_image;
 
+    /* Block engine reading carrier bytes from stego image */
+    LsbEngine engine;
+
+    /* Worker threads for the data stage (-j N) */
+    int threads;
+
+    /* With one thread, overlap carrier reads, extraction and writes on three (off with --no-pipeline) */
+    int pipeline;
+
+    /* Payload bits per carrier byte, read from the header flags */
+    int bits;
+
+    /* Data is a stream of LZ frames, read from the header flags */
+    int compressed;
+
+    /* Data is followed by a CRC32C, read from the header flags */
+    int crc;
+
+    /* Frames are sealed, read from the header flags */
+    int encrypted;
+
+    /* Data is an archive of files, read from the header flags */
+    int archive;
+
+    /* Size unknown when encoded (0): the end frame closes the data, read from the header flags */
+    int streamed;
+
+    /* Data blocks are in the key's order over the image, read from the header flags */
+    int scattered;
+
+    /* Data and CRC are coded in Reed-Solomon stripes, read from the header flags */
+    int fec;
+
+    /* Key to open sealed frames, NULL when none was given */
+    const unsigned char *key;
+
+    /* Decode only payload bytes [range_offset, range_offset + range_length), 0 length: to the end */
+    long range_offset;
+    long range_length;
+
+    /* Why the last decoding failed */
+    StegoError error;
+
+    /* Per-stage timing, off unless the caller asked for stats */
+    StageClock clock;
+
 } DecodeInfo;
 
 /* Encoding function prototype */
@@ -42,6 +92,9 @@ Status read_and_validate_decode_args(char *argv[], DecodeInfo *decInfo);
 /* Perform the encoding */
 Status do_decoding(DecodeInfo *encInfo);
 
+/* Run the decoding stages through an initialised engine */
+Status decode_image(DecodeInfo *decInfo);
+
 /* Get File pointers for i/p and o/p files */
 Status open_img_file(DecodeInfo *decInfo);
 
@@ -64,6 +117,9 @@ Status decode_secret_file_size(DecodeInfo *decInfo);
 /* Encode secret file data*/
 Status decode_secret_file_data(DecodeInfo *decInfo);
 
+/* Check the data against its CRC32C trailer */
+Status decode_secret_file_crc(DecodeInfo *decInfo);
+
 /* Encode function, which does the real encoding */
 // Status decode_image_to_data(const char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image);
 
@@ -5,6 +5,17 @@ Description : Steganography
 */
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <unistd.h>
+#include "lsb_kernels.h"
+#include "parallel.h"
+#include "lsb_pipeline.h"
+#include "stego_log.h"
+#include "lz.h"
+#include "aead.h"
+#include "bmp.h"
 #include "decode.h"
 #include "types.h"
 #include "common.h"
@@ -14,32 +25,62 @@ Status read_and_validate_decode_args(char *argv[], DecodeInfo *decInfo)
 {
     decInfo->fptr_stego_image = NULL;
     decInfo->fptr_secret = NULL;
-
-    // Validate that the input image is a .bmp file
+    decInfo->engine.block = NULL;
+    decInfo->engine.span = NULL;
+    decInfo->engine.map = NULL;
+    decInfo->engine.head = NULL;
+    decInfo->engine.scatter.order = NULL;
+    decInfo->engine.fec = NULL;
+    stage_clock_start(&decInfo->clock, NULL);
+    decInfo->threads = 1;
+    decInfo->pipeline = 0;
+    decInfo->bits = 1;
+    decInfo->compressed = 0;
+    decInfo->crc = 0;
+    decInfo->encrypted = 0;
+    decInfo->archive = 0;
+    decInfo->streamed = 0;
+    decInfo->scattered = 0;
+    decInfo->fec = 0;
+    decInfo->key = NULL;
+    decInfo->range_offset = 0;
+    decInfo->range_length = 0;
+    decInfo->size_secret_file = 0;
+
+    // Validate that the input image is a .bmp file, or - for stdin
     char *bmp = strstr(argv[2], ".bmp");
-    if ((bmp != NULL) && strcmp(bmp, ".bmp") == 0)
+    if (strcmp(argv[2], STREAM_NAME) == 0)
+    {
+        decInfo->stego_image_fname = argv[2];
+    }
+    else if ((bmp != NULL) && strcmp(bmp, ".bmp") == 0)
     {
-        printf("\n✅ Input file has .bmp extension\n");
+        stego_info("\n✅ Input file has .bmp extension\n");
         decInfo->stego_image_fname = argv[2];
     }
     else
     {
-        printf("❌ Entered file name is wrong \n");
+        stego_error("❌ Entered file name is wrong \n");
         return e_failure;
     }
 
     // Use default secret file name if not provided
     if (argv[3] == NULL)
     {
-        printf("✅ INFO: Output File not mentioned. Creating secret_file as default\n");
+        stego_info("✅ INFO: Output File not mentioned. Creating secret_file as default\n");
         strcpy(decInfo->secret_fname, "secret_file");
     }
     else
     {
         if (strchr(argv[3], '.') != NULL)
         {
-            printf("Error: ❌ Do not include file extension in output filename\n");
-            printf("[INFO] Provide filename without extension <output_file>\n");
+            stego_error("Error: ❌ Do not include file extension in output filename\n");
+            stego_info("[INFO] Provide filename without extension <output_file>\n");
+            return e_failure;
+        }
+        if (strlen(argv[3]) + MAX_FILE_SUFFIX >= MAX_SECRET_FNAME)
+        {
+            stego_error("Error: ❌ Output filename is too long\n");
             return e_failure;
         }
         strcpy(decInfo->secret_fname, argv[3]);
@@ -51,100 +92,227 @@ Status read_and_validate_decode_args(char *argv[], DecodeInfo *decInfo)
 // Main decoding function for full decoding process
 Status do_decoding(DecodeInfo *decInfo)
 {
-    printf("--------------------------------------------------------\n");
-    printf("        INFO: ## Decoding Procedure Started ## \n");
-    printf("---------------------------------------------------------\n\n");
-    printf("✅ INFO: Opening required files\n");
+    BmpLayout layout;
+    unsigned char *head = NULL;
+    Status ret;
+
+    stego_info("--------------------------------------------------------\n");
+    stego_info("        INFO: ## Decoding Procedure Started ## \n");
+    stego_info("---------------------------------------------------------\n\n");
+    stego_info("✅ INFO: Opening required files\n");
 
     // Open the stego image for reading
-    decInfo->fptr_stego_image = fopen(decInfo->stego_image_fname, "r");
+    if (strcmp(decInfo->stego_image_fname, STREAM_NAME) == 0)
+        decInfo->fptr_stego_image = stdin;
+    else
+        decInfo->fptr_stego_image = fopen(decInfo->stego_image_fname, "r");
 
     if (decInfo->fptr_stego_image == NULL)
     {
-        perror("fopen");
-        fprintf(stderr, "ERROR:❌ Unable to open file %s\n", decInfo->stego_image_fname);
+        decInfo->error = e_stego_io;
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", decInfo->stego_image_fname, strerror(errno));
+        return e_failure;
+    }
+    stego_info("✅ INFO: Opened %s\n", decInfo->stego_image_fname);
+
+    // Only the headers are read here: where the pixels are and how rows are laid out
+    // (off stdin they are consumed, and the engine then only reads forward)
+    if (decInfo->fptr_stego_image == stdin)
+        ret = bmp_read_stream(decInfo->fptr_stego_image, &head, &layout, 1);
+    else
+        ret = bmp_read_layout(decInfo->fptr_stego_image, &layout, 1);
+    if (ret == e_failure)
+    {
+        decInfo->error = e_stego_bad_image;
+        stego_error("ERROR:❌ %s is not an uncompressed 24 or 32 bpp BMP\n", decInfo->stego_image_fname);
         return e_failure;
     }
-    printf("✅ INFO: Opened %s\n", decInfo->stego_image_fname);
-    printf("✅ INFO: Done\n\n");
 
+    // Set up the block engine over the stego image
+    if (lsb_engine_init(&decInfo->engine, decInfo->fptr_stego_image, NULL, &layout) == e_failure)
+    {
+        free(head);
+        decInfo->error = e_stego_no_memory;
+        stego_error("❌ Unable to allocate decoding buffer\n");
+        return e_failure;
+    }
+    if (head != NULL)
+        lsb_engine_set_head(&decInfo->engine, head);
+    stego_info("✅ INFO: Done\n\n");
+
+    return decode_image(decInfo);
+}
+
+// A range was asked for: only part of the payload is decoded
+static int is_range(const DecodeInfo *decInfo)
+{
+    return decInfo->range_offset > 0 || decInfo->range_length > 0;
+}
+
+// First payload byte past the range, cut short at the end of the payload (only the end frame
+// knows where a streamed one ends)
+static long range_end(const DecodeInfo *decInfo)
+{
+    long end = decInfo->range_offset + decInfo->range_length;
+
+    if (decInfo->streamed)
+        return LONG_MAX;
+    return decInfo->range_length == 0 || end > decInfo->size_secret_file ? decInfo->size_secret_file : end;
+}
+
+// A stripe had more damaged bytes than its parity corrects: the image, not the disk, is at fault
+static void report_fec_lost(DecodeInfo *decInfo)
+{
+    decInfo->error = e_stego_corrupt;
+    stego_error("ERROR:❌ %s is damaged past what its error correction can put right\n", decInfo->stego_image_fname);
+}
+
+// Run every decoding stage through an initialised engine
+Status decode_image(DecodeInfo *decInfo)
+{
     // Decode and verify magic string
-    printf("🔓 Info: Decoding the Magic String\n");
+    stage_enter(&decInfo->clock, e_stage_magic);
+    stego_info("🔓 Info: Decoding the Magic String\n");
     if (decode_magic_string(decInfo) == e_failure)
     {
-        printf("❌ Magic string is not present\n");
+        decInfo->error = e_stego_not_stego;
+        stego_error("❌ Magic string is not present\n");
         return e_failure;
     }
-    printf("✅ INFO: Done\n\n");
+    stego_info("✅ INFO: Done\n\n");
 
     // Decode size of the secret file extension
-    printf("🔓 INFO: Decoding Output File Extension size\n");
+    stage_enter(&decInfo->clock, e_stage_extn_size);
+    stego_info("🔓 INFO: Decoding Output File Extension size\n");
     if (decode_secret_file_extn_size(decInfo) == e_failure)
     {
-        printf("❌ Failed to get extension size\n");
+        decInfo->error = e_stego_corrupt;
+        stego_error("❌ Failed to get extension size\n");
         return e_failure;
     }
-    printf("✅ INFO: Done\n\n");
+    stego_info("✅ INFO: Done\n\n");
 
-    // Decode the actual secret file extension (like .txt/.c/.sh)
-    printf("🔓 INFO: Decoding Output File Extension\n");
-    if (decode_secret_file_extn(decInfo) == e_failure)
+    // An archive has no single output file: its entries are listed and extracted by name
+    if (decInfo->archive)
     {
-        printf("❌ Falied to get extension\n");
+        decInfo->error = e_stego_is_archive;
+        stego_error("❌ %s holds an archive of files: list it with -l, extract with -x\n", decInfo->stego_image_fname);
         return e_failure;
     }
-    printf("✅ INFO: Done\n\n");
 
-    // Open output file to store the recovered secret
-    printf("🔓 INFO: Opening  %s\n", decInfo->secret_fname);
-    decInfo->fptr_secret = fopen(decInfo->secret_fname, "w");
-    if (decInfo->fptr_secret == NULL) // Bug: Should check decInfo->fptr_secret instead
+    // The flags word said the data is sealed: without the key there is nothing to recover
+    if (decInfo->encrypted && decInfo->key == NULL)
     {
-        perror("fopen");
-        fprintf(stderr, "ERROR:❌ Unable to open file %s\n", decInfo->secret_fname);
+        decInfo->error = e_stego_no_key;
+        stego_error("ERROR:❌ %s is encrypted and no key was given\n", decInfo->stego_image_fname);
         return e_failure;
     }
-    printf("✅ INFO: Opened all required files\n");
-    printf("✅ INFO: Done\n\n");
 
-    // Decode the size of the secret file
-    printf("🔓 INFO: Decoding %s File Size\n", decInfo->secret_fname);
+    // Any failure from here on is a read or write error
+    decInfo->error = e_stego_io;
+
+    // Decode the actual secret file extension (like .txt/.c/.sh)
+    stage_enter(&decInfo->clock, e_stage_extn);
+    stego_info("🔓 INFO: Decoding Output File Extension\n");
+    if (decode_secret_file_extn(decInfo) == e_failure)
+    {
+        stego_error("❌ Falied to get extension\n");
+        return e_failure;
+    }
+    stego_info("✅ INFO: Done\n\n");
+
+    // Decode the size of the secret file: it and the fields before it are checked before the output
+    // is opened, so a decode that cannot succeed leaves an existing file of that name as it was
+    stage_enter(&decInfo->clock, e_stage_size);
+    stego_info("🔓 INFO: Decoding %s File Size\n", decInfo->secret_fname);
     if (decode_secret_file_size(decInfo) == e_failure)
     {
-        printf("❌ Falied to get file size\n");
+        stego_error("❌ Falied to get file size\n");
         return e_failure;
     }
-    printf("✅ INFO: Done\n\n");
+    stego_info("✅ INFO: Done\n\n");
+
+    // Open output file to store the recovered secret (the library may hand one in)
+    if (decInfo->fptr_secret == NULL)
+    {
+        stage_enter(&decInfo->clock, e_stage_open);
+        stego_info("🔓 INFO: Opening  %s\n", decInfo->secret_fname);
+        if (strcmp(decInfo->secret_fname, STREAM_NAME) == 0)
+            decInfo->fptr_secret = stdout;
+        else
+            decInfo->fptr_secret = fopen(decInfo->secret_fname, "w");
+        if (decInfo->fptr_secret == NULL)
+        {
+            stego_error("ERROR:❌ Unable to open file %s: %s\n", decInfo->secret_fname, strerror(errno));
+            return e_failure;
+        }
+        stego_info("✅ INFO: Opened all required files\n");
+        stego_info("✅ INFO: Done\n\n");
+    }
 
     // Decode the actual content of the secret file
-    printf("🔓 INFO: Decoding the secret file data\n");
+    stage_enter(&decInfo->clock, e_stage_data);
+    if (decInfo->threads > 1)
+        stego_info("🔓 INFO: Decoding the secret file data at %d bit(s) per byte using %d threads\n",
+                   decInfo->bits, decInfo->threads);
+    else
+        stego_info("🔓 INFO: Decoding the secret file data at %d bit(s) per byte\n", decInfo->bits);
     if (decode_secret_file_data(decInfo) == e_failure)
     {
-        printf("❌ Failed at decoding file data\n");
+        if (decInfo->engine.fec_lost)
+            report_fec_lost(decInfo);
+        stego_error("❌ Failed at decoding file data\n");
         return e_failure;
     }
-    printf("✅ INFO: Done\n\n");
+    stego_info("✅ INFO: Done\n\n");
 
+    // Images written before the checksum existed carry none, and a range does not cover all it sums
+    if (decInfo->crc && is_range(decInfo))
+    {
+        stego_info("⚠️  INFO: Checksum covers the whole payload, not verified for a range\n\n");
+    }
+    else if (decInfo->crc)
+    {
+        stage_enter(&decInfo->clock, e_stage_crc);
+        stego_info("🔐 INFO: Verifying the secret file checksum\n");
+        if (decode_secret_file_crc(decInfo) == e_failure)
+        {
+            if (decInfo->engine.fec_lost)
+                report_fec_lost(decInfo);
+            stego_error("❌ Failed at verifying file data\n");
+            return e_failure;
+        }
+        stego_info("✅ INFO: Done\n\n");
+    }
+
+    if (decInfo->engine.fec_corrected > 0)
+        stego_info("🩹 INFO: Error correction put %ld damaged byte(s) right\n\n", decInfo->engine.fec_corrected);
+
+    decInfo->error = e_stego_ok;
     return e_success;
 }
 
-// Decodes the embedded magic string from the image
-Status decode_magic_string(DecodeInfo *decInfo)
+// Older encoders ran the carrier on from byte 54 over every byte: read such images that way
+static Status use_legacy_layout(DecodeInfo *decInfo)
 {
-    fseek(decInfo->fptr_stego_image, 54, SEEK_SET); // Skip BMP header
-    int i;
-    char buffer[8], ch, magicString[strlen(MAGIC_STRING) + 1];
+    BmpLayout legacy;
 
-    // Decode each character of the magic string
-    for (i = 0; i < strlen(MAGIC_STRING); i++)
+    bmp_legacy_layout(&decInfo->engine.layout, &legacy);
+    return lsb_engine_set_layout(&decInfo->engine, &legacy);
+}
+
+// Reads the magic string from the first carrier byte and compares it
+static Status read_magic_string(DecodeInfo *decInfo)
+{
+    lsb_engine_seek(&decInfo->engine, 0); // First pixel byte
+    int i = strlen(MAGIC_STRING);
+    char magicString[strlen(MAGIC_STRING) + 1];
+
+    // Decode the whole magic string in one engine call
+    if (lsb_engine_extract(&decInfo->engine, magicString, i) == e_failure)
     {
-        if (fread(buffer, 8, 1, decInfo->fptr_stego_image) != 1)
-        {
-            printf("ERROR:❌ Failed to read  %s while decoding magic string\n", decInfo->stego_image_fname);
-            return e_failure;
-        }
-        decode_byte_from_lsb(&ch, buffer);
-        magicString[i] = ch;
+        stego_error("ERROR:❌ Failed to read  %s while decoding magic string\n", decInfo->stego_image_fname);
+        return e_failure;
     }
     magicString[i] = '\0';
 
@@ -156,10 +324,22 @@ Status decode_magic_string(DecodeInfo *decInfo)
     return e_failure;
 }
 
+// Decodes the embedded magic string from the image
+Status decode_magic_string(DecodeInfo *decInfo)
+{
+    if (read_magic_string(decInfo) == e_success)
+        return e_success;
+
+    // Not where this layout puts it: maybe where older encoders did
+    if (bmp_matches_legacy(&decInfo->engine.layout) || use_legacy_layout(decInfo) == e_failure)
+        return e_failure;
+    return read_magic_string(decInfo);
+}
+
 // Decodes a single byte from LSBs of 8 bytes
 Status decode_byte_from_lsb(char *ch, char *buffer)
 {
-    int i, get, clear, k, j = 7;
+    int i, get, j = 7;
     *ch = 0;
     for (i = 0; i <= 7; i++)
     {
@@ -173,27 +353,65 @@ Status decode_byte_from_lsb(char *ch, char *buffer)
 // Decodes the size of the secret file's extension (e.g. 4 for ".txt")
 Status decode_secret_file_extn_size(DecodeInfo *decInfo)
 {
-    char buffer[32];
-    if (fread(buffer, 32, 1, decInfo->fptr_stego_image) != 1)
+    int word, density;
+
+    if (lsb_engine_extract_int(&decInfo->engine, &word) == e_failure)
+    {
+        stego_error("ERROR:❌ Failed to read %s while decoding extension size\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+
+    // The magic string also sits there in the old layout when the first row is wide enough:
+    // without the layout flag, this image came from an older encoder
+    if (!(word & FLAG_PIXEL_LAYOUT) && !bmp_matches_legacy(&decInfo->engine.layout))
     {
-        printf("ERROR:❌ Failed to read %s while decoding extension size\n", decInfo->stego_image_fname);
+        if (use_legacy_layout(decInfo) == e_failure || read_magic_string(decInfo) == e_failure ||
+            lsb_engine_extract_int(&decInfo->engine, &word) == e_failure)
+        {
+            stego_error("ERROR:❌ Unable to read %s in the layout of older encoders\n", decInfo->stego_image_fname);
+            return e_failure;
+        }
+    }
+
+    // Flags above the size: reject any this decoder does not know
+    if (word & ~(EXTN_SIZE_MASK | KNOWN_HEADER_FLAGS))
+    {
+        stego_error("ERROR:❌ Unknown format flags 0x%x in %s\n", word & ~EXTN_SIZE_MASK, decInfo->stego_image_fname);
+        return e_failure;
+    }
+    density = (word & DENSITY_MASK) >> DENSITY_SHIFT;
+    if (density > 2)
+    {
+        stego_error("ERROR:❌ Invalid data density in %s\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+    decInfo->bits = 1 << density;
+    decInfo->compressed = (word & FLAG_COMPRESSED) != 0;
+    decInfo->crc = (word & FLAG_CRC) != 0;
+    decInfo->encrypted = (word & FLAG_ENCRYPTED) != 0;
+    decInfo->archive = (word & FLAG_ARCHIVE) != 0;
+    decInfo->streamed = (word & FLAG_STREAMED) != 0;
+    decInfo->scattered = (word & FLAG_SCATTERED) != 0;
+    decInfo->fec = (word & FLAG_FEC) != 0;
+    decInfo->secret_file_extn_size = word & EXTN_SIZE_MASK;
+
+    // Anything longer than ".txt" was not written by our encoder
+    if (decInfo->secret_file_extn_size > MAX_FILE_SUFFIX)
+    {
+        stego_error("ERROR:❌ Invalid extension size %d in %s\n", decInfo->secret_file_extn_size, decInfo->stego_image_fname);
         return e_failure;
     }
-    decode_int_from_lsb(&(decInfo->secret_file_extn_size), buffer);
     return e_success;
 }
 
-// Decodes a 32-bit integer (size) from LSBs
+// Decodes a 32-bit integer (size) from LSBs, MSB first
 Status decode_int_from_lsb(int *size, char *image_buffer)
 {
-    *size = 0;
-    int i, get, j = 31;
-    for (i = 0; i <= 31; i++)
-    {
-        get = image_buffer[i] & 1;
-        *size |= (get << j);
-        j--;
-    }
+    unsigned char bytes[4];
+
+    lsb_kernel()->extract(bytes, (unsigned char *)image_buffer, 4);
+    // Shifted unsigned: a damaged size field may have its top bit set
+    *size = (int)((uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3]);
     return e_success;
 }
 
@@ -201,23 +419,19 @@ Status decode_int_from_lsb(int *size, char *image_buffer)
 Status decode_secret_file_extn(DecodeInfo *decInfo)
 {
     char extension[decInfo->secret_file_extn_size + 1];
-    char buffer[8], ch;
-    int i;
+    int i = decInfo->secret_file_extn_size;
 
-    for (i = 0; i < decInfo->secret_file_extn_size; i++)
+    if (lsb_engine_extract(&decInfo->engine, extension, i) == e_failure)
     {
-        if (fread(buffer, 8, 1, decInfo->fptr_stego_image) != 1)
-        {
-            printf("ERROR:❌ Failed to read %s while decoding file extension \n", decInfo->stego_image_fname);
-            return e_failure;
-        }
-        decode_byte_from_lsb(&ch, buffer);
-        extension[i] = ch;
+        stego_error("ERROR:❌ Failed to read %s while decoding file extension \n", decInfo->stego_image_fname);
+        return e_failure;
     }
     extension[i] = '\0';
+    strcpy(decInfo->extn_secret_file, extension);
 
-    // Append extension to the output file name
-    strcat(decInfo->secret_fname, extension);
+    // Append extension to the output file name (stdout has none)
+    if (strcmp(decInfo->secret_fname, STREAM_NAME) != 0)
+        strcat(decInfo->secret_fname, extension);
 
     return e_success;
 }
@@ -225,40 +439,294 @@ Status decode_secret_file_extn(DecodeInfo *decInfo)
 // Decodes the total size of the secret file
 Status decode_secret_file_size(DecodeInfo *decInfo)
 {
-    char buffer[32];
-    if (fread(buffer, 32, 1, decInfo->fptr_stego_image) != 1)
+    if (lsb_engine_extract_int(&decInfo->engine, &(decInfo->size_secret_file)) == e_failure)
     {
-        printf("ERROR:❌ Failed to read %s while decoding secret file size\n", decInfo->stego_image_fname);
+        stego_error("ERROR:❌ Failed to read %s while decoding secret file size\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+
+    // A negative size can only come from a damaged or foreign image
+    if (decInfo->size_secret_file < 0)
+    {
+        decInfo->error = e_stego_corrupt;
+        stego_error("ERROR:❌ Invalid secret file size %d in %s\n", decInfo->size_secret_file, decInfo->stego_image_fname);
+        return e_failure;
+    }
+
+    // A streamed payload only learns its size at the end frame: a range cannot be placed in it
+    if (decInfo->streamed && is_range(decInfo))
+    {
+        decInfo->error = e_stego_bad_args;
+        stego_error("ERROR:❌ %s was encoded from a stream of unknown size: decode it whole\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+
+    // Coded data is read a whole stripe at a time, from the first one on
+    if (decInfo->fec && is_range(decInfo))
+    {
+        decInfo->error = e_stego_bad_args;
+        stego_error("ERROR:❌ %s is coded in error correction stripes: decode it whole\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+
+    // A range must start inside the payload; one running past its end is cut short
+    if (decInfo->range_offset > decInfo->size_secret_file)
+    {
+        decInfo->error = e_stego_bad_args;
+        stego_error("ERROR:❌ Range starts at byte %ld of a %d byte payload\n", decInfo->range_offset, decInfo->size_secret_file);
+        return e_failure;
+    }
+
+    // The data follows in the block order the key gives, which only a mapped image can jump through
+    if (decInfo->scattered && decInfo->key == NULL)
+    {
+        decInfo->error = e_stego_no_key;
+        stego_error("ERROR:❌ %s is scattered under a key and no key was given\n", decInfo->stego_image_fname);
+        return e_failure;
+    }
+    if (decInfo->scattered && lsb_engine_scatter(&decInfo->engine, decInfo->key) == e_failure)
+    {
+        stego_error("ERROR:❌ Unable to follow the scattered data of %s: it must be a regular file\n", decInfo->stego_image_fname);
         return e_failure;
     }
-    decode_int_from_lsb(&(decInfo->size_secret_file), buffer);
     return e_success;
 }
 
+// Read frames until the zero end frame, opening sealed frames and expanding
+// LZ frames on the way
+static Status decode_framed_data(DecodeInfo *decInfo)
+{
+    long tag = decInfo->encrypted ? AEAD_TAG_SIZE : 0;
+    unsigned char *frame = malloc(LZ_BOUND(LSB_PAYLOAD_BLOCK) + AEAD_TAG_SIZE);
+    unsigned char *data = malloc(LSB_PAYLOAD_BLOCK);
+    unsigned char bytes[FRAME_HEADER_SIZE];
+    unsigned char nonce[AEAD_NONCE_SIZE];
+    const unsigned char *out;
+    long total = 0, length, size, expect, from, to;
+    long start = decInfo->range_offset, end = range_end(decInfo);
+    uint header, index = 0;
+    Status ret = e_failure;
+
+    if (frame == NULL || data == NULL)
+    {
+        stego_error("ERROR:❌ Unable to allocate buffer while decoding data\n");
+        free(frame);
+        free(data);
+        return e_failure;
+    }
+    if (decInfo->encrypted &&
+        lsb_engine_extract(&decInfo->engine, (char *)nonce, NONCE_PREFIX_SIZE) == e_failure)
+    {
+        stego_error("ERROR:❌ Failed to read %s while decoding file data\n", decInfo->stego_image_fname);
+        free(frame);
+        free(data);
+        return e_failure;
+    }
+
+    while (1)
+    {
+        // A range is done once its last byte is out: the frames after it are never read
+        if (is_range(decInfo) && total >= end)
+        {
+            ret = e_success;
+            break;
+        }
+
+        if (lsb_engine_extract(&decInfo->engine, (char *)bytes, FRAME_HEADER_SIZE) == e_failure)
+        {
+            stego_error("ERROR:❌ Failed to read %s while decoding file data\n", decInfo->stego_image_fname);
+            break;
+        }
+        header = ((uint)bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+
+        length = header & FRAME_LENGTH_MASK;
+        if (length > ((header & FRAME_COMPRESSED) ? LZ_BOUND(LSB_PAYLOAD_BLOCK) : LSB_PAYLOAD_BLOCK))
+        {
+            decInfo->error = e_stego_corrupt;
+            stego_error("ERROR:❌ Invalid frame length %ld in %s\n", length, decInfo->stego_image_fname);
+            break;
+        }
+
+        // Frames wholly before the range are stepped over by their headers, contents unread;
+        // with a key, a tampered length derails the walk onto a frame that fails authentication
+        expect = decInfo->size_secret_file - total < LSB_PAYLOAD_BLOCK ? decInfo->size_secret_file - total : LSB_PAYLOAD_BLOCK;
+        if (header != 0 && is_range(decInfo) && total + expect <= start)
+        {
+            if (!(header & FRAME_COMPRESSED) && length != expect)
+            {
+                decInfo->error = e_stego_corrupt;
+                stego_error("ERROR:❌ Invalid frame length %ld in %s\n", length, decInfo->stego_image_fname);
+                break;
+            }
+            if (lsb_engine_skip(&decInfo->engine, LSB_CARRIER_SIZE(length + tag, decInfo->bits)) == e_failure)
+            {
+                stego_error("ERROR:❌ Failed to read %s while decoding file data\n", decInfo->stego_image_fname);
+                break;
+            }
+            total += expect;
+            index += decInfo->encrypted;
+            continue;
+        }
+
+        if (lsb_engine_extract(&decInfo->engine, (char *)frame, length + tag) == e_failure)
+        {
+            stego_error("ERROR:❌ Failed to read %s while decoding file data\n", decInfo->stego_image_fname);
+            break;
+        }
+
+        // Nothing of a sealed frame is used before its tag checks out, the end frame's included
+        if (decInfo->encrypted)
+        {
+            nonce[8] = index >> 24;
+            nonce[9] = index >> 16;
+            nonce[10] = index >> 8;
+            nonce[11] = index;
+            if (aead_open(decInfo->key, nonce, bytes, FRAME_HEADER_SIZE, frame, length, frame + length) == e_failure)
+            {
+                decInfo->error = e_stego_auth_failed;
+                stego_error("ERROR:❌ Frame %u of %s failed authentication: wrong key or tampered data\n",
+                            index, decInfo->stego_image_fname);
+                break;
+            }
+            index++;
+        }
+
+        // End frame: everything the size field promised must be there (streamed: the size is this)
+        if (header == 0)
+        {
+            if (decInfo->streamed)
+                decInfo->size_secret_file = total;
+            if (total == decInfo->size_secret_file)
+                ret = e_success;
+            else
+            {
+                decInfo->error = e_stego_corrupt;
+                stego_error("ERROR:❌ %s holds %ld of %d data bytes\n", decInfo->stego_image_fname, total, decInfo->size_secret_file);
+            }
+            break;
+        }
+
+        out = frame;
+        size = length;
+        if (header & FRAME_COMPRESSED)
+        {
+            size = lz_decompress(frame, length, data, LSB_PAYLOAD_BLOCK);
+            out = data;
+        }
+        if (size < 0 || (!decInfo->streamed && total + size > decInfo->size_secret_file) ||
+            (is_range(decInfo) && size != expect) || total + size > INT_MAX)
+        {
+            decInfo->error = e_stego_corrupt;
+            stego_error("ERROR:❌ Corrupt compressed frame in %s\n", decInfo->stego_image_fname);
+            break;
+        }
+
+        // Only the part of the frame inside the range is written
+        from = start > total ? start - total : 0;
+        to = end < total + size ? end - total : size;
+        if (fwrite(out + from, 1, to - from, decInfo->fptr_secret) != (size_t)(to - from))
+        {
+            stego_error("ERROR:❌ Failed to write %s into %s decoding data\n", decInfo->stego_image_fname, decInfo->secret_fname);
+            break;
+        }
+        total += size;
+    }
+
+    free(frame);
+    free(data);
+    return ret;
+}
+
 // Decodes the actual content of the secret file
 Status decode_secret_file_data(DecodeInfo *decInfo)
 {
-    char buffer[8], ch;
-    int i;
+    char *data;
+    long done, chunk, end = range_end(decInfo);
+    uint32_t crc;
+    Status ret = e_success;
 
-    for (i = 0; i < decInfo->size_secret_file; i++)
+    // The header said how densely the data is packed, and whether to checksum it
+    if (lsb_engine_set_bits(&decInfo->engine, decInfo->bits) == e_failure)
+        return e_failure;
+    lsb_engine_track_crc(&decInfo->engine, decInfo->crc && !is_range(decInfo));
+    if (decInfo->fec && lsb_engine_set_fec(&decInfo->engine, 1) == e_failure)
+        return e_failure;
+
+    if (decInfo->compressed || decInfo->encrypted)
+        return decode_framed_data(decInfo);
+
+    // Payload byte i sits 8 / bits carrier bytes after byte i - 1: a range start is one seek away
+    if (decInfo->range_offset > 0 &&
+        lsb_engine_skip(&decInfo->engine, LSB_CARRIER_SIZE(decInfo->range_offset, decInfo->bits)) == e_failure)
+    {
+        stego_error("ERROR:❌ Failed to seek %s to byte %ld of the data\n", decInfo->stego_image_fname, decInfo->range_offset);
+        return e_failure;
+    }
+
+    // Every output byte's carrier position is known now: pread/pwrite in slices
+    // (a mapped image and an output file, not stdin or stdout)
+    if (decInfo->threads > 1 && !decInfo->fec && decInfo->engine.map != NULL && strcmp(decInfo->secret_fname, STREAM_NAME) != 0)
     {
-        if (fread(buffer, 8, 1, decInfo->fptr_stego_image) != 1)
+        int fd_out = fileno(decInfo->fptr_secret);
+
+        // Pre-size the output so workers can write their slices in any order
+        chunk = end - decInfo->range_offset;
+        if (fflush(decInfo->fptr_secret) != 0 || ftruncate(fd_out, chunk) != 0 ||
+            parallel_extract(fileno(decInfo->fptr_stego_image), &decInfo->engine.layout, fd_out,
+                             lsb_engine_tell(&decInfo->engine),
+                             chunk, decInfo->bits, decInfo->threads, &crc) == e_failure)
         {
-            printf("ERROR:❌ Failed to read %s while decoding file data\n", decInfo->stego_image_fname);
+            stego_error("ERROR:❌ Failed to decode %s into %s in parallel\n", decInfo->stego_image_fname, decInfo->secret_fname);
             return e_failure;
         }
+        fseek(decInfo->fptr_secret, chunk, SEEK_SET);
+        lsb_engine_add_crc(&decInfo->engine, crc, chunk);
+        return lsb_engine_skip(&decInfo->engine, LSB_CARRIER_SIZE(chunk, decInfo->bits));
+    }
 
-        decode_byte_from_lsb(&ch, buffer);
-
-        // Write the decoded byte into the secret output file
-        if (fwrite(&ch, 1, 1, decInfo->fptr_secret) != 1)
+    // One block being read, one extracted and one written at a time: the three overlap
+    if (decInfo->pipeline && !decInfo->fec && end - decInfo->range_offset > LSB_PAYLOAD_BLOCK)
+    {
+        if (lsb_pipeline_extract(&decInfo->engine, decInfo->fptr_secret, end - decInfo->range_offset) == e_failure)
         {
-            printf("ERROR:❌ Failed to write %s into %s decoding data\n", decInfo->stego_image_fname, decInfo->secret_fname);
+            stego_error("ERROR:❌ Failed to decode %s into %s\n", decInfo->stego_image_fname, decInfo->secret_fname);
             return e_failure;
         }
+        return e_success;
     }
-    return e_success;
+
+    data = malloc(LSB_PAYLOAD_BLOCK);
+    if (data == NULL)
+    {
+        stego_error("ERROR:❌ Unable to allocate buffer while decoding data\n");
+        return e_failure;
+    }
+
+    // Decode a payload block at a time and write it out in one go
+    for (done = decInfo->range_offset; done < end; done += chunk)
+    {
+        chunk = end - done;
+        if (chunk > LSB_PAYLOAD_BLOCK)
+            chunk = LSB_PAYLOAD_BLOCK;
+
+        if (lsb_engine_extract(&decInfo->engine, data, chunk) == e_failure)
+        {
+            stego_error("ERROR:❌ Failed to read %s while decoding file data\n", decInfo->stego_image_fname);
+            ret = e_failure;
+            break;
+        }
+
+        // Write the decoded block into the secret output file
+        if (fwrite(data, 1, chunk, decInfo->fptr_secret) != chunk)
+        {
+            stego_error("ERROR:❌ Failed to write %s into %s decoding data\n", decInfo->stego_image_fname, decInfo->secret_fname);
+            ret = e_failure;
+            break;
+        }
+    }
+
+    free(data);
+    return ret;
 }
 
 // Closes the opened stego and secret output files
@@ -278,8 +746,32 @@ void close_decode_files(DecodeInfo *decInfo)
         fclose(decInfo->fptr_secret);
     }
 
+    lsb_engine_free(&decInfo->engine);
+
     if (flag)
     {
-        printf("✅ INFO: Successfully closed files\n");
+        stego_info("✅ INFO: Successfully closed files\n");
+    }
+}
+
+// Compares the CRC32C trailer with the one collected while extracting the data
+Status decode_secret_file_crc(DecodeInfo *decInfo)
+{
+    uint32_t crc = decInfo->engine.crc;
+    unsigned char bytes[CRC_SIZE];
+    uint32_t stored;
+
+    lsb_engine_track_crc(&decInfo->engine, 0);
+    if (lsb_engine_extract(&decInfo->engine, (char *)bytes, CRC_SIZE) == e_failure)
+        return e_failure;
+
+    stored = (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+    if (stored != crc)
+    {
+        stego_error("ERROR:❌ Checksum mismatch in %s: stored %08x, data gives %08x\n",
+                    decInfo->stego_image_fname, stored, crc);
+        decInfo->error = e_stego_corrupt;
+        return e_failure;
     }
+    return e_success;
 }
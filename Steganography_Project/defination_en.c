@@ -9,6 +9,14 @@ Description : Steganography
 #include "types.h"
 #include "common.h"
 #include <stdlib.h>
+#include "lsb_kernels.h"
+#include "parallel.h"
+#include "lsb_pipeline.h"
+#include "stego_log.h"
+#include "lz.h"
+#include "aead.h"
+#include "bmp.h"
+#include <sys/random.h>
 
 // Determine the operation type based on command-line argument
 OperationType check_operation_type(char *argv[])
@@ -21,6 +29,34 @@ OperationType check_operation_type(char *argv[])
     {
         return e_decode;
     }
+    else if ((strcmp(argv[1], "-b") == 0))
+    {
+        return e_batch;
+    }
+    else if ((strcmp(argv[1], "-a") == 0))
+    {
+        return e_analyze;
+    }
+    else if ((strcmp(argv[1], "-s") == 0))
+    {
+        return e_scan;
+    }
+    else if ((strcmp(argv[1], "-c") == 0))
+    {
+        return e_archive;
+    }
+    else if ((strcmp(argv[1], "-l") == 0))
+    {
+        return e_list;
+    }
+    else if ((strcmp(argv[1], "-x") == 0))
+    {
+        return e_extract;
+    }
+    else if ((strcmp(argv[1], "-D") == 0))
+    {
+        return e_daemon;
+    }
     else
     {
         return e_unsupported;
@@ -34,22 +70,53 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
     encInfo->fptr_src_image = NULL;
     encInfo->fptr_secret = NULL;
     encInfo->fptr_stego_image = NULL;
-
-    // Validate source image (must be .bmp)
+    encInfo->secret_data = NULL;
+    encInfo->engine.block = NULL;
+    encInfo->engine.span = NULL;
+    encInfo->engine.map = NULL;
+    encInfo->engine.head = NULL;
+    encInfo->engine.scatter.order = NULL;
+    encInfo->engine.fec = NULL;
+    stage_clock_start(&encInfo->clock, NULL);
+    encInfo->threads = 1;
+    encInfo->pipeline = 0;
+    encInfo->bits = 1;
+    encInfo->compress = 0;
+    encInfo->crc = 1;
+    encInfo->key = NULL;
+    encInfo->scatter = 0;
+    encInfo->fec = 0;
+    encInfo->archive = NULL;
+    encInfo->in_place = 0;
+    encInfo->streamed = 0;
+    encInfo->size_secret_file = 0;
+
+    // Validate source image (must be .bmp, or - for stdin)
     char *ch = strchr(argv[2], '.');
-    if ((ch != NULL) && (strcmp(ch, ".bmp")) == 0)
+    if (strcmp(argv[2], STREAM_NAME) == 0 || ((ch != NULL) && (strcmp(ch, ".bmp")) == 0))
     {
         encInfo->src_image_fname = argv[2];
     }
     else
     {
-        printf("❌ Error : source file must be a .bmp file\n");
+        stego_error("❌ Error : source file must be a .bmp file\n");
         return e_failure;
     }
 
-    // Validate and store secret file extension
+    // Validate and store secret file extension; stdin has none, and its size is not known up front
     ch = strchr(argv[3], '.');
-    if ((ch != NULL) && (strcmp(ch, ".txt")) == 0)
+    if (strcmp(argv[3], STREAM_NAME) == 0)
+    {
+        if (strcmp(argv[2], STREAM_NAME) == 0)
+        {
+            stego_error("❗ Source image and secret file cannot both be read from stdin\n");
+            return e_failure;
+        }
+        encInfo->secret_fname = argv[3];
+        encInfo->extn_secret_file[0] = '\0';
+        encInfo->streamed = 1;
+    }
+    else if ((ch != NULL) && (strcmp(ch, ".txt")) == 0)
     {
         encInfo->secret_fname = argv[3];
         strcpy(encInfo->extn_secret_file, ".txt");
@@ -66,7 +133,7 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
     }
     else
     {
-        printf("❗ Secret file extn must be contain .txt/.c/.sh\n");
+        stego_error("❗ Secret file extn must be contain .txt/.c/.sh\n");
         return e_failure;
     }
 
@@ -78,13 +145,13 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
     else
     {
         ch = strchr(argv[4], '.');
-        if ((ch != NULL) && (strcmp(ch, ".bmp")) == 0)
+        if (strcmp(argv[4], STREAM_NAME) == 0 || ((ch != NULL) && (strcmp(ch, ".bmp")) == 0))
         {
             encInfo->stego_image_fname = argv[4];
         }
         else
         {
-            printf("❗ Encoded file must be .bmp file\n");
+            stego_error("❗ Encoded file must be .bmp file\n");
             return e_failure;
         }
     }
@@ -95,115 +162,318 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo)
 // Main function to perform the encoding process
 Status do_encoding(EncodeInfo *encInfo)
 {
-    printf("------------------------------------------------\n");
-    printf("    INFO: ## Encoding Procedure Started ## \n");
-    printf("------------------------------------------------\n");
+    BmpLayout layout;
+    unsigned char *head = NULL;
+    Status ret;
+
+    stego_info("------------------------------------------------\n");
+    stego_info("    INFO: ## Encoding Procedure Started ## \n");
+    stego_info("------------------------------------------------\n");
 
     // Open files for reading/writing
     if (open_files(encInfo) == e_failure)
     {
-        printf("File is not open\n");
+        encInfo->error = e_stego_io;
+        stego_error("File is not open\n");
+        return e_failure;
+    }
+    stego_info("✅ Opend Source file to read : %s\n", encInfo->src_image_fname);
+    stego_info("✅ Opend secret file to read : %s\n", encInfo->secret_fname);
+    stego_info("✅ Opend destination file for writing : %s\n", encInfo->stego_image_fname);
+    stego_info("✅ All files are open successfully\n");
+
+    // Only the headers are read here: where the pixels are and how rows are laid out
+    // (a piped source cannot be read twice, so its headers are kept for the copy)
+    if (strcmp(encInfo->src_image_fname, STREAM_NAME) == 0)
+        ret = bmp_read_stream(encInfo->fptr_src_image, &head, &layout, 0);
+    else
+        ret = bmp_read_layout(encInfo->fptr_src_image, &layout, 0);
+    if (ret == e_failure)
+    {
+        encInfo->error = e_stego_bad_image;
+        stego_error("❌ %s is not an uncompressed 24 or 32 bpp BMP\n", encInfo->src_image_fname);
+        return e_failure;
+    }
+
+    // Set up the block engine between source and stego image
+    if (lsb_engine_init(&encInfo->engine, encInfo->fptr_src_image, encInfo->fptr_stego_image, &layout) == e_failure)
+    {
+        free(head);
+        encInfo->error = e_stego_no_memory;
+        stego_error("❌ Unable to allocate encoding buffer\n");
+        return e_failure;
+    }
+    if (head != NULL)
+        lsb_engine_set_head(&encInfo->engine, head);
+
+    // In place: the changed carrier bytes go back into the source, nothing else is written
+    if (encInfo->in_place && lsb_engine_patch_source(&encInfo->engine) == e_failure)
+    {
+        encInfo->error = e_stego_io;
+        stego_error("❌ %s can only be encoded in place when it is a regular file\n", encInfo->src_image_fname);
+        return e_failure;
+    }
+    stego_info("✅ Done\n\n");
+
+    if (encode_image(encInfo) == e_failure)
+        return e_failure;
+    if (encInfo->in_place)
+        stego_info("✍️  Wrote %ld bytes of %s in place, in %ld writes\n", encInfo->engine.patch_bytes,
+                   encInfo->src_image_fname, encInfo->engine.patch_writes);
+    return e_success;
+}
+
+// Run every encoding stage through an initialised engine
+Status encode_image(EncodeInfo *encInfo)
+{
+    // The key orders the blocks, and they are written out of order: no pipes either side
+    if (encInfo->scatter && encInfo->key == NULL)
+    {
+        encInfo->error = e_stego_bad_args;
+        stego_error("❌ Scattering the data needs a key (-K)\n");
+        return e_failure;
+    }
+    if (encInfo->scatter &&
+        (strcmp(encInfo->src_image_fname, STREAM_NAME) == 0 || strcmp(encInfo->stego_image_fname, STREAM_NAME) == 0))
+    {
+        encInfo->error = e_stego_bad_args;
+        stego_error("❌ Scattered data can only be written between image files, not stdin or stdout\n");
         return e_failure;
     }
-    printf("✅ Opend Source file to read : beautiful.bmp\n");
-    printf("✅ Opend secret file to read : secret.txt\n");
-    printf("✅ Opend destination file for writing : stego.bmp\n");
-    printf("✅ All files are open successfully\n");
-    printf("✅ Done\n\n");
 
     // Check if image has enough capacity to hold data
-    printf("🔍 Checking beautiful.bmp file for space to handle the secret file.txt\n");
+    stage_enter(&encInfo->clock, e_stage_check);
+    stego_info("🔍 Checking %s for space to handle the secret file\n", encInfo->src_image_fname);
     if (check_capacity(encInfo) == e_failure)
     {
-        printf("❌ There is no enough space\n");
+        encInfo->error = e_stego_no_capacity;
+        stego_error("❌ There is no enough space\n");
         return e_failure;
     }
-    printf("✅ Image file has sufficient space\n");
-    printf("✅ Done\n\n");
+    stego_info("✅ Image file has sufficient space\n");
+    stego_info("✅ Done\n\n");
+
+    // Any failure from here on is a read or write error
+    encInfo->error = e_stego_io;
 
-    // Copy 54-byte BMP header
-    printf("📝 copying the bmp file header into dest file\n");
-    if (copy_bmp_header(encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_failure)
+    // Copy the BMP headers up to the pixel array
+    stage_enter(&encInfo->clock, e_stage_header);
+    stego_info("📝 copying the bmp file header into dest file\n");
+    if (copy_bmp_header(&encInfo->engine) == e_failure)
     {
-        printf("❌ Error : in copying bmp\n");
+        stego_error("❌ Error : in copying bmp\n");
+        return e_failure;
     }
-    printf("✅ Header file copied successfully\n");
-    printf("✅ Done\n\n");
+    stego_info("✅ Header file copied successfully\n");
+    stego_info("✅ Done\n\n");
 
     // Encode magic string
-    printf("🔐 Encoding the Magic String into the dest\n");
+    stage_enter(&encInfo->clock, e_stage_magic);
+    stego_info("🔐 Encoding the Magic String into the dest\n");
     if (encode_magic_string(MAGIC_STRING, encInfo) == e_failure)
     {
-        printf("❌ Error:magic string encode process\n");
+        stego_error("❌ Error:magic string encode process\n");
         return e_failure;
     }
-    printf("✅ Magic String copied successfully\n");
-    printf("✅ Done\n\n");
-
-    // Encode extension length
-    printf("🔐 Encoding the secret file extn size into dest\n");
-    if (encode_secret_file_extn_size(strlen(encInfo->extn_secret_file), encInfo) == e_failure)
+    stego_info("✅ Magic String copied successfully\n");
+    stego_info("✅ Done\n\n");
+
+    // Encode extension length, with the payload density in the flag bits above it
+    stage_enter(&encInfo->clock, e_stage_extn_size);
+    stego_info("🔐 Encoding the secret file extn size into dest\n");
+    if (encode_secret_file_extn_size(strlen(encInfo->extn_secret_file) |
+                                         (__builtin_ctz(encInfo->bits) << DENSITY_SHIFT) |
+                                         (encInfo->compress || encInfo->streamed ? FLAG_COMPRESSED : 0) |
+                                         (encInfo->crc ? FLAG_CRC : 0) |
+                                         (encInfo->key ? FLAG_ENCRYPTED : 0) |
+                                         (encInfo->archive ? FLAG_ARCHIVE : 0) |
+                                         (encInfo->streamed ? FLAG_STREAMED : 0) |
+                                         (encInfo->scatter ? FLAG_SCATTERED : 0) |
+                                         (encInfo->fec ? FLAG_FEC : 0) |
+                                         (bmp_matches_legacy(&encInfo->engine.layout) ? 0 : FLAG_PIXEL_LAYOUT),
+                                     encInfo) == e_failure)
     {
-        printf("❌ File size can't copied successfully\n");
+        stego_error("❌ File size can't copied successfully\n");
         return e_failure;
     }
-    printf("✅ Secret file extn size Encoded successfully\n");
-    printf("✅ Done\n\n");
+    stego_info("✅ Secret file extn size Encoded successfully\n");
+    stego_info("✅ Done\n\n");
 
     // Encode actual extension
-    printf("🔐 Encoding the secret file extn into the dest\n");
+    stage_enter(&encInfo->clock, e_stage_extn);
+    stego_info("🔐 Encoding the secret file extn into the dest\n");
     if (encode_secret_file_extn(encInfo->extn_secret_file, encInfo) == e_failure)
     {
-        printf("❌ Error : in copying secret file extension\n");
+        stego_error("❌ Error : in copying secret file extension\n");
         return e_failure;
     }
-    printf("✅ Secret file extension copied to image successfully\n");
-    printf("✅ Done\n\n");
+    stego_info("✅ Secret file extension copied to image successfully\n");
+    stego_info("✅ Done\n\n");
 
     // Encode size of the secret file
-    printf("🔐 Encodig the secret file size into dest\n");
+    stage_enter(&encInfo->clock, e_stage_size);
+    stego_info("🔐 Encodig the secret file size into dest\n");
     if (encode_secret_file_size(encInfo->size_secret_file, encInfo) == e_failure)
     {
-        printf("❌ Error: in copying secret file size\n");
+        stego_error("❌ Error: in copying secret file size\n");
         return e_failure;
     }
-    printf("✅ Secret file size Encoded successfully\n");
-    printf("✅ Done\n\n");
+    stego_info("✅ Secret file size Encoded successfully\n");
+    stego_info("✅ Done\n\n");
 
     // Encode the contents of the secret file
-    printf("🔐 Encode Secret file data into dest\n");
+    stage_enter(&encInfo->clock, e_stage_data);
+
+    // Keyed scattering: the data and its checksum go to blocks all over the image
+    if (encInfo->scatter)
+    {
+        stego_info("🔀 Scattering the data over %s in %d KiB blocks\n", encInfo->stego_image_fname, SCATTER_BLOCK / 1024);
+        if (lsb_engine_scatter(&encInfo->engine, encInfo->key) == e_failure)
+        {
+            stego_error("❌ Error: unable to scatter the data over %s\n", encInfo->stego_image_fname);
+            return e_failure;
+        }
+    }
+    if (encInfo->threads > 1)
+        stego_info("🔐 Encode Secret file data into dest at %d bit(s) per byte using %d threads\n",
+                   encInfo->bits, encInfo->threads);
+    else
+        stego_info("🔐 Encode Secret file data into dest at %d bit(s) per byte\n", encInfo->bits);
+    if (encInfo->fec)
+        stego_info("🩹 Coding the data in Reed-Solomon stripes of %d bytes, %d of them parity\n", FEC_STRIPE_SIZE,
+                   FEC_STRIPE_SIZE - FEC_STRIPE_DATA);
     if (encode_secret_file_data(encInfo) == e_failure)
     {
-        printf("❌ Error: failed in copiying scret file data\n");
+        stego_error("❌ Error: failed in copiying scret file data\n");
+        return e_failure;
+    }
+    stego_info("✅ Encoded secret file data into image successfully\n");
+    stego_info("✅ Done\n\n");
+
+    // Checksum of the data, embedded right after it
+    if (encInfo->crc)
+    {
+        stage_enter(&encInfo->clock, e_stage_crc);
+        stego_info("🔐 Encoding the secret file checksum into dest\n");
+        if (encode_secret_file_crc(encInfo) == e_failure)
+        {
+            stego_error("❌ Error: in copying secret file checksum\n");
+            return e_failure;
+        }
+        stego_info("✅ Secret file checksum Encoded successfully\n");
+        stego_info("✅ Done\n\n");
+    }
+
+    // The last stripe goes in padded with zeros
+    if (encInfo->fec && lsb_engine_set_fec(&encInfo->engine, 0) == e_failure)
+    {
+        stego_error("❌ Error: in coding the last stripe of data\n");
         return e_failure;
     }
-    printf("✅ Encoded secret file data into image successfully\n");
-    printf("✅ Done\n\n");
 
     // Copy remaining image data that wasn't used for encoding
-    printf("🔐 Encodeing remaining data into dest\n");
-    if (copy_remaining_img_data(encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_failure)
+    stage_enter(&encInfo->clock, e_stage_remainder);
+    stego_info("🔐 Encodeing remaining data into dest\n");
+    if (copy_remaining_img_data(&encInfo->engine) == e_failure)
     {
-        printf("❌ Can't copy the remaining data\n");
+        stego_error("❌ Can't copy the remaining data\n");
         return e_failure;
     }
-    printf("✅ Copied remaining data from source to dest successfully\n");
+    stego_info("✅ Copied remaining data from source to dest successfully\n");
+
+    encInfo->error = e_stego_ok;
     return e_success;
 }
 
+// Next size bytes of the secret, from memory or from the file
+static Status read_secret(EncodeInfo *encInfo, char *buffer, long offset, long size)
+{
+    if (encInfo->secret_data != NULL)
+    {
+        memcpy(buffer, encInfo->secret_data + offset, size);
+        return e_success;
+    }
+    return fread(buffer, 1, size, encInfo->fptr_secret) == (size_t)size ? e_success : e_failure;
+}
+
+// Compress the first block; when it does not shrink, embed the whole secret as it is
+static Status probe_compression(EncodeInfo *encInfo)
+{
+    long chunk = encInfo->size_secret_file < LSB_PAYLOAD_BLOCK ? encInfo->size_secret_file : LSB_PAYLOAD_BLOCK;
+    char *buffer = malloc(chunk + 1);
+    unsigned char *packed = malloc(LZ_BOUND(chunk));
+    long length = -1;
+    Status ret = e_failure;
+
+    if (buffer != NULL && packed != NULL)
+    {
+        if (encInfo->fptr_secret != NULL)
+            rewind(encInfo->fptr_secret);
+        if (read_secret(encInfo, buffer, 0, chunk) == e_success)
+        {
+            length = lz_compress((unsigned char *)buffer, chunk, packed, LZ_BOUND(chunk));
+            ret = e_success;
+        }
+    }
+
+    if (ret == e_success && (length < 0 || length + FRAME_HEADER_SIZE >= chunk))
+    {
+        encInfo->compress = 0;
+        stego_info("🗜  Secret file does not compress, embedding it as is\n");
+    }
+    else if (ret == e_success)
+    {
+        stego_info("🗜  Secret file compresses (%ld -> %ld bytes in the first block)\n", chunk, length);
+    }
+
+    free(buffer);
+    free(packed);
+    return ret;
+}
+
+// Bytes each frame adds to its contents: the header, and the tag when sealed
+static long frame_overhead(const EncodeInfo *encInfo)
+{
+    return FRAME_HEADER_SIZE + (encInfo->key ? AEAD_TAG_SIZE : 0);
+}
+
 // Check if image has enough capacity to embed secret file
 Status check_capacity(EncodeInfo *encInfo)
 {
-    int total_capacity;
+    long total_capacity, data;
 
-    // Get total number of usable bytes in BMP image
-    encInfo->image_capacity = get_image_size_for_bmp(encInfo->fptr_src_image);
+    // Carrier bytes of the pixel array, padding and alpha bytes left out
+    encInfo->image_capacity = encInfo->engine.layout.usable;
 
-    // Get size of secret file
-    encInfo->size_secret_file = get_file_size(encInfo->fptr_secret);
+    // Get size of secret file (preset for in-memory secrets, unknown on stdin)
+    if (encInfo->fptr_secret != NULL && !encInfo->streamed)
+        encInfo->size_secret_file = get_file_size(encInfo->fptr_secret);
 
-    // Calculate required capacity
-    total_capacity = 54 + ((strlen(MAGIC_STRING) + 4 + strlen(encInfo->extn_secret_file) + 4 + encInfo->size_secret_file) * 8);
+    // Calculate required capacity: header fields at 1 bit, the data at the chosen density
+    total_capacity = (strlen(MAGIC_STRING) + 4 + strlen(encInfo->extn_secret_file) + 4) * 8;
+
+    // Scattered data only goes into whole blocks after the header fields
+    if (encInfo->scatter)
+        encInfo->image_capacity = SCATTER_USABLE(total_capacity, encInfo->image_capacity);
+    if (encInfo->compress && !encInfo->streamed && probe_compression(encInfo) == e_failure)
+        return e_failure;
+
+    // Compressed and streamed frames are checked as they are embedded: only the end frame must fit now
+    data = encInfo->size_secret_file;
+    if (encInfo->compress || encInfo->key || encInfo->streamed)
+    {
+        data = (encInfo->key ? NONCE_PREFIX_SIZE : 0) + frame_overhead(encInfo);
+        if (!encInfo->compress)
+            data += encInfo->size_secret_file +
+                    (encInfo->size_secret_file + LSB_PAYLOAD_BLOCK - 1) / LSB_PAYLOAD_BLOCK * frame_overhead(encInfo);
+    }
+
+    // The checksum follows the data; coded, both go in whole stripes
+    if (encInfo->crc)
+        data += CRC_SIZE;
+    if (encInfo->fec)
+        data = FEC_CODED_SIZE(data);
+    total_capacity += LSB_CARRIER_SIZE(data, encInfo->bits);
 
     // Check if image can hold everything
     if (encInfo->image_capacity >= total_capacity)
@@ -221,38 +491,25 @@ uint get_file_size(FILE *fptr)
     return ftell(fptr);       // Return size in bytes
 }
 
-// Copy BMP header (first 54 bytes) unchanged
-Status copy_bmp_header(FILE *fptr_src_image, FILE *fptr_dest_image)
+// Copy BMP headers (everything up to bfOffBits) unchanged
+Status copy_bmp_header(LsbEngine *engine)
 {
-    char buffer[54];
-    rewind(fptr_src_image);
-    fread(buffer, 54, 1, fptr_src_image);
-    fwrite(buffer, 54, 1, fptr_dest_image);
-    return e_success;
+    return lsb_engine_copy_header(engine);
 }
 
 // Encode predefined magic string into image
 Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo)
 {
-    if (encode_data_to_image(magic_string, strlen(magic_string), encInfo->fptr_src_image, encInfo->fptr_stego_image) == e_success)
+    if (encode_data_to_image(magic_string, strlen(magic_string), &encInfo->engine) == e_success)
         return e_success;
     else
         return e_failure;
 }
 
-// Encode any string (char-by-char) into LSBs of image
-Status encode_data_to_image(const char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image)
+// Encode any string into LSBs of image, a whole block of carrier bytes at a time
+Status encode_data_to_image(const char *data, long size, LsbEngine *engine)
 {
-    char buffer[8];
-    int i;
-    // printf("%s\n", data);
-    for (i = 0; i < size; i++)
-    {
-        fread(buffer, 8, 1, fptr_src_image);    // Read 8 bytes from image
-        encode_byte_to_lsb(data[i], buffer);    // Modify LSBs to hold 1 byte of data
-        fwrite(buffer, 8, 1, fptr_stego_image); // Write modified data
-    }
-    return e_success;
+    return lsb_engine_embed(engine, data, size);
 }
 
 // Encode a single byte into 8 LSBs of image buffer
@@ -273,81 +530,235 @@ Status encode_byte_to_lsb(char data, char *image_buffer)
 // Encode length of file extension into 32 LSBs
 Status encode_secret_file_extn_size(int extn_size, EncodeInfo *encoInfo)
 {
-    int i;
-    char buffer[32];
-
-    if (fread(buffer, 32, 1, encoInfo->fptr_src_image) != 1)
-        return e_failure;
-
-    encode_int_to_lsb(extn_size, buffer);
-    fwrite(buffer, 32, 1, encoInfo->fptr_stego_image);
-    return e_success;
+    return lsb_engine_embed_int(&encoInfo->engine, extn_size);
 }
 
-// Encode 32-bit integer into LSBs
+// Encode 32-bit integer into LSBs (MSB first, same order as 4 data bytes)
 Status encode_int_to_lsb(int data, char *image_buffer)
 {
-    int get, clear, i, j = 31;
-    for (i = 0; i < 32; i++)
-    {
-        get = (data >> j) & 1;
-        j--;
+    unsigned char bytes[4];
 
-        clear = (image_buffer[i]) & (~1);
-        image_buffer[i] = get | clear;
-    }
+    bytes[0] = data >> 24;
+    bytes[1] = data >> 16;
+    bytes[2] = data >> 8;
+    bytes[3] = data;
+    lsb_kernel()->embed((unsigned char *)image_buffer, (unsigned char *)image_buffer, bytes, 4);
     return e_success;
 }
 
 // Encode actual extension (.txt/.c/.sh) into image
 Status encode_secret_file_extn(const char *file_extn, EncodeInfo *encInfo)
 {
-    char buffer[strlen(file_extn)];
-    encode_data_to_image(file_extn, strlen(file_extn), encInfo->fptr_src_image, encInfo->fptr_stego_image);
-    return e_success;
+    return encode_data_to_image(file_extn, strlen(file_extn), &encInfo->engine);
 }
 
 // Encode secret file size into image
 Status encode_secret_file_size(int file_size, EncodeInfo *encInfo)
 {
-    char buffer[32]; // Note: unnecessary allocation for 32 bytes
-    if (fread(buffer, 32, 1, encInfo->fptr_src_image) != 1)
+    // printf("file size : %ld\n", encInfo->size_secret_file);
+    return lsb_engine_embed_int(&encInfo->engine, file_size);
+}
+
+// Embed the secret as frames, one payload block each, LZ compressed when that
+// shrinks the block and sealed when there is a key, then the zero end frame
+static Status encode_framed_data(EncodeInfo *encInfo)
+{
+    char *buffer = malloc(LSB_PAYLOAD_BLOCK);
+    unsigned char *frame = malloc(FRAME_HEADER_SIZE + LZ_BOUND(LSB_PAYLOAD_BLOCK) + AEAD_TAG_SIZE);
+    unsigned char nonce[AEAD_NONCE_SIZE];
+    long done, chunk, length, room;
+    uint header, index = 0;
+    Status ret = e_failure;
+
+    if (buffer == NULL || frame == NULL)
+    {
+        stego_error("ERROR:❌ Unable to allocate frame buffers\n");
+        free(buffer);
+        free(frame);
         return e_failure;
+    }
+    if (encInfo->fptr_secret != NULL && !encInfo->streamed)
+        rewind(encInfo->fptr_secret);
 
-    encode_int_to_lsb(file_size, buffer);
-    fwrite(buffer, 32, 1, encInfo->fptr_stego_image);
+    // A fresh nonce prefix per image, so a key can be reused safely
+    if (encInfo->key != NULL &&
+        (getrandom(nonce, NONCE_PREFIX_SIZE, 0) != NONCE_PREFIX_SIZE ||
+         encode_data_to_image((char *)nonce, NONCE_PREFIX_SIZE, &encInfo->engine) == e_failure))
+    {
+        stego_error("ERROR:❌ Unable to start the encrypted stream\n");
+        free(buffer);
+        free(frame);
+        return e_failure;
+    }
 
-    // printf("file size : %ld\n", encInfo->size_secret_file);
-    return e_success;
+    for (done = 0;; done += chunk)
+    {
+        // From stdin, full blocks until a short one at end of file (fread waits them out)
+        if (encInfo->streamed)
+        {
+            chunk = fread(buffer, 1, LSB_PAYLOAD_BLOCK, encInfo->fptr_secret);
+            if (ferror(encInfo->fptr_secret))
+            {
+                stego_error("ERROR:❌ Unable to read the secret from stdin\n");
+                break;
+            }
+        }
+        else
+        {
+            chunk = encInfo->size_secret_file - done;
+            if (chunk > LSB_PAYLOAD_BLOCK)
+                chunk = LSB_PAYLOAD_BLOCK;
+        }
+
+        // Zero header once the whole secret is in
+        header = 0;
+        length = 0;
+        if (chunk > 0)
+        {
+            if (!encInfo->streamed && read_secret(encInfo, buffer, done, chunk) == e_failure)
+                break;
+            length = -1;
+            if (encInfo->compress)
+                length = lz_compress((unsigned char *)buffer, chunk, frame + FRAME_HEADER_SIZE, LZ_BOUND(chunk));
+            if (length < 0 || length >= chunk)
+            {
+                memcpy(frame + FRAME_HEADER_SIZE, buffer, chunk);
+                length = chunk;
+                header = length;
+            }
+            else
+            {
+                header = length | FRAME_COMPRESSED;
+            }
+        }
+        frame[0] = header >> 24;
+        frame[1] = header >> 16;
+        frame[2] = header >> 8;
+        frame[3] = header;
+
+        // This frame, the end frame and the checksum after it must still fit
+        room = (long)encInfo->image_capacity - lsb_engine_tell(&encInfo->engine);
+        if (lsb_engine_carrier_for(&encInfo->engine, frame_overhead(encInfo) + length +
+                                                         (chunk > 0 ? frame_overhead(encInfo) : 0) +
+                                                         (encInfo->crc ? CRC_SIZE : 0)) > room)
+        {
+            encInfo->error = e_stego_no_capacity;
+            stego_error("❌ Compressed secret does not fit into %s\n", encInfo->src_image_fname);
+            break;
+        }
+
+        // Seal the frame contents in place, the tag right behind them
+        if (encInfo->key != NULL)
+        {
+            nonce[8] = index >> 24;
+            nonce[9] = index >> 16;
+            nonce[10] = index >> 8;
+            nonce[11] = index;
+            index++;
+            aead_seal(encInfo->key, nonce, frame, FRAME_HEADER_SIZE, frame + FRAME_HEADER_SIZE, length,
+                      frame + FRAME_HEADER_SIZE + length);
+            length += AEAD_TAG_SIZE;
+        }
+
+        if (encode_data_to_image((char *)frame, FRAME_HEADER_SIZE + length, &encInfo->engine) == e_failure)
+            break;
+        if (chunk == 0)
+        {
+            ret = e_success;
+            break;
+        }
+    }
+
+    free(buffer);
+    free(frame);
+    return ret;
 }
 
-// Embed actual content of secret file byte-by-byte
+// Embed actual content of secret file, streamed through a fixed-size chunk
 Status encode_secret_file_data(EncodeInfo *encInfo)
 {
-    char ch;
+    char *buffer;
+    long done, chunk;
+    uint32_t crc;
+    Status ret = e_success;
+
+    // Only the data is packed at the higher densities, and only the data is checksummed
+    if (lsb_engine_set_bits(&encInfo->engine, encInfo->bits) == e_failure)
+        return e_failure;
+    lsb_engine_track_crc(&encInfo->engine, encInfo->crc);
+    if (encInfo->fec && lsb_engine_set_fec(&encInfo->engine, 1) == e_failure)
+        return e_failure;
+
+    if (encInfo->archive != NULL)
+        return encode_archive_data(encInfo);
+    if (encInfo->compress || encInfo->key != NULL || encInfo->streamed)
+        return encode_framed_data(encInfo);
+
+    // In-memory secret: hand it to the engine as it is
+    if (encInfo->secret_data != NULL)
+        return encode_data_to_image(encInfo->secret_data, encInfo->size_secret_file, &encInfo->engine);
+
+    // Threads need positional access to both images: mapped source, seekable dest
+    // (they write whole spans, so in place the engine alone compares bytes)
+    if (encInfo->threads > 1 && encInfo->engine.map != NULL && !encInfo->in_place && !encInfo->fec &&
+        strcmp(encInfo->stego_image_fname, STREAM_NAME) != 0)
+    {
+        if (fflush(encInfo->fptr_stego_image) != 0 ||
+            parallel_embed(encInfo->engine.map, &encInfo->engine.layout, fileno(encInfo->fptr_secret),
+                           fileno(encInfo->fptr_stego_image), lsb_engine_tell(&encInfo->engine), encInfo->size_secret_file, encInfo->bits, encInfo->threads,
+                           &crc) == e_failure)
+            return e_failure;
+        lsb_engine_add_crc(&encInfo->engine, crc, encInfo->size_secret_file);
+        return lsb_engine_skip(&encInfo->engine, LSB_CARRIER_SIZE(encInfo->size_secret_file, encInfo->bits));
+    }
+
     rewind(encInfo->fptr_secret); // Reset file pointer to start of secret file
 
-    char buffer[encInfo->size_secret_file];
+    // One block being read, one embedded and one written at a time: the three overlap
+    if (encInfo->pipeline && encInfo->size_secret_file > LSB_PAYLOAD_BLOCK && !encInfo->in_place && !encInfo->fec)
+        return lsb_pipeline_embed(&encInfo->engine, encInfo->fptr_secret, encInfo->size_secret_file);
 
-    if (fread(buffer, encInfo->size_secret_file, 1, encInfo->fptr_secret) != 1)
+    // One payload block at a time, so memory use does not grow with the secret
+    buffer = malloc(LSB_PAYLOAD_BLOCK);
+    if (buffer == NULL)
     {
         return e_failure;
     }
 
-    buffer[encInfo->size_secret_file] = '\0';
+    for (done = 0; done < encInfo->size_secret_file; done += chunk)
+    {
+        chunk = encInfo->size_secret_file - done;
+        if (chunk > LSB_PAYLOAD_BLOCK)
+            chunk = LSB_PAYLOAD_BLOCK;
 
-    encode_data_to_image(buffer, encInfo->size_secret_file, encInfo->fptr_src_image, encInfo->fptr_stego_image);
+        if (fread(buffer, 1, chunk, encInfo->fptr_secret) != chunk ||
+            encode_data_to_image(buffer, chunk, &encInfo->engine) == e_failure)
+        {
+            ret = e_failure;
+            break;
+        }
+    }
 
-    return e_success;
+    free(buffer);
+    return ret;
+}
+
+// Embed the CRC32C collected while the data went through the engine
+Status encode_secret_file_crc(EncodeInfo *encInfo)
+{
+    uint32_t crc = encInfo->engine.crc;
+    char bytes[CRC_SIZE];
+
+    lsb_engine_track_crc(&encInfo->engine, 0);
+    bytes[0] = crc >> 24;
+    bytes[1] = crc >> 16;
+    bytes[2] = crc >> 8;
+    bytes[3] = crc;
+    return encode_data_to_image(bytes, CRC_SIZE, &encInfo->engine);
 }
 
 // Copy remaining image data after encoding is complete
-Status copy_remaining_img_data(FILE *fptr_src, FILE *fptr_dest)
+Status copy_remaining_img_data(LsbEngine *engine)
 {
-    char ch;
-    while (fread(&ch, 1, 1, fptr_src) > 0)
-    {
-        fwrite(&ch, 1, 1, fptr_dest);
-    }
-    return e_success;
+    return lsb_engine_copy_rest(engine);
 }
@@ -4,33 +4,35 @@ Date        : 24-07-2025
 Description : Steganography
 */
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 #include "encode.h"
 #include "types.h"
+#include "stego_log.h"
+#include "bmp.h"
+#include "common.h"
 
 /* Function Definitions */
 
 /* Get image size
  * Input: Image file ptr
- * Output: width * height * bytes per pixel (3 in our case)
- * Description: In BMP Image, width is stored in offset 18,
- * and height after that. size is 4 bytes
+ * Output: carrier bytes of the pixel array (B, G, R of every pixel), 0 if not a usable BMP
+ * Description: Only the headers are read, see bmp_parse() for the
+ * pixel offset, row padding, 32 bpp and top-down images
  */
 uint get_image_size_for_bmp(FILE *fptr_image)
 {
-    uint width, height;
-    // Seek to 18th byte
-    fseek(fptr_image, 18, SEEK_SET);
+    BmpLayout layout;
 
-    // Read the width (an int)
-    fread(&width, sizeof(int), 1, fptr_image);
-    // printf("width = %u\n", width);
-
-    // Read the height (an int)
-    fread(&height, sizeof(int), 1, fptr_image);
-    // printf("height = %u\n", height);
+    if (bmp_read_layout(fptr_image, &layout, 0) == e_failure)
+        return 0;
+    return layout.usable;
+}
 
-    // Return image capacity
-    return width * height * 3;
+// Open fname, or hand back std when it is STREAM_NAME
+static FILE *open_stream(const char *fname, const char *mode, FILE *std)
+{
+    return strcmp(fname, STREAM_NAME) == 0 ? std : fopen(fname, mode);
 }
 
 /*
@@ -42,35 +44,35 @@ uint get_image_size_for_bmp(FILE *fptr_image)
  */
 Status open_files(EncodeInfo *encInfo)
 {
-    // Src Image file
-    encInfo->fptr_src_image = fopen(encInfo->src_image_fname, "r");
+    // Src Image file, also the one written when encoding in place
+    encInfo->fptr_src_image = open_stream(encInfo->src_image_fname, encInfo->in_place ? "r+" : "r", stdin);
     // Do Error handling
     if (encInfo->fptr_src_image == NULL)
     {
-        perror("fopen");
-        fprintf(stderr, "ERROR:❌ Unable to open file %s\n", encInfo->src_image_fname);
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", encInfo->src_image_fname, strerror(errno));
 
         return e_failure;
     }
 
-    // Secret file
-    encInfo->fptr_secret = fopen(encInfo->secret_fname, "r");
+    // Secret file (archive members are opened one at a time as they are embedded)
+    if (encInfo->archive == NULL)
+        encInfo->fptr_secret = open_stream(encInfo->secret_fname, "r", stdin);
     // Do Error handling
-    if (encInfo->fptr_secret == NULL)
+    if (encInfo->archive == NULL && encInfo->fptr_secret == NULL)
     {
-        perror("fopen");
-        fprintf(stderr, "ERROR:❌ Unable to open file %s\n", encInfo->secret_fname);
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", encInfo->secret_fname, strerror(errno));
 
         return e_failure;
     }
 
     // Stego Image file
-    encInfo->fptr_stego_image = fopen(encInfo->stego_image_fname, "w");
+    if (encInfo->in_place)
+        return e_success;
+    encInfo->fptr_stego_image = open_stream(encInfo->stego_image_fname, "w", stdout);
     // Do Error handling
     if (encInfo->fptr_stego_image == NULL)
     {
-        perror("fopen");
-        fprintf(stderr, "ERROR:❌ Unable to open file %s\n", encInfo->stego_image_fname);
+        stego_error("ERROR:❌ Unable to open file %s: %s\n", encInfo->stego_image_fname, strerror(errno));
 
         return e_failure;
     }
@@ -99,8 +101,10 @@ void close_encode_files(EncodeInfo *encInfo)
         flag = 1;
         fclose(encInfo->fptr_src_image);
     }
+    lsb_engine_free(&encInfo->engine);
+
     if (flag)
     {
-        printf("✅ INFO: Successfully closed files\n");
+        stego_info("✅ INFO: Successfully closed files\n");
     }
 }
\ No newline at end of file
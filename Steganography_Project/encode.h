@@ -2,6 +2,9 @@
 #define ENCODE_H
 
 #include "types.h" // Contains user defined types
+#include "lsb_engine.h"
+#include "stego.h"
+#include "stego_stats.h"
 
 /*
  * Structure to store information required for
@@ -26,14 +29,57 @@ typedef struct
     /* Secret File Info */
     char *secret_fname;
     FILE *fptr_secret;
-    char extn_secret_file[MAX_FILE_SUFFIX];
+    char extn_secret_file[MAX_FILE_SUFFIX + 1];
     // char secret_data[MAX_SECRET_BUF_SIZE];
+    const char *secret_data; /* In-memory secret (library API), NULL: read fptr_secret */
     long size_secret_file;
 
     /* Stego Image Info */
     char *stego_image_fname;
     FILE *fptr_stego_image;
 
+    /* Block engine moving carrier bytes from source to stego image */
+    LsbEngine engine;
+
+    /* Worker threads for the data stage (-j N) */
+    int threads;
+
+    /* With one thread, overlap secret reads, embedding and writes on three (off with --no-pipeline) */
+    int pipeline;
+
+    /* Payload bits per carrier byte: 1, 2 or 4 (-k N) */
+    int bits;
+
+    /* Embed the secret as LZ frames (-z), cleared when it does not shrink */
+    int compress;
+
+    /* Append a CRC32C of the data (on unless --no-crc) */
+    int crc;
+
+    /* ChaCha20-Poly1305 key sealing every frame, NULL: no encryption */
+    const unsigned char *key;
+
+    /* Spread the data over the image in block order shuffled by the key (--scatter) */
+    int scatter;
+
+    /* Code the data and CRC in Reed-Solomon stripes (--fec) */
+    int fec;
+
+    /* Secret read from stdin: its size is unknown, so it is embedded as frames */
+    int streamed;
+
+    /* Patch the source image itself instead of writing a stego image (--in-place) */
+    int in_place;
+
+    /* Files embedded behind a table of contents instead of one secret, NULL: none */
+    struct Archive *archive;
+
+    /* Why the last encoding failed */
+    StegoError error;
+
+    /* Per-stage timing, off unless the caller asked for stats */
+    StageClock clock;
+
 } EncodeInfo;
 
 /* Encoding function prototype */
@@ -47,6 +93,9 @@ Status read_and_validate_encode_args(char *argv[], EncodeInfo *encInfo);
 /* Perform the encoding */
 Status do_encoding(EncodeInfo *encInfo);
 
+/* Run the encoding stages through an initialised engine */
+Status encode_image(EncodeInfo *encInfo);
+
 /* Get File pointers for i/p and o/p files */
 Status open_files(EncodeInfo *encInfo);
 
@@ -60,7 +109,7 @@ uint get_image_size_for_bmp(FILE *fptr_image);
 uint get_file_size(FILE *fptr);
 
 /* Copy bmp image header */
-Status copy_bmp_header(FILE *fptr_src_image, FILE *fptr_dest_image);
+Status copy_bmp_header(LsbEngine *engine);
 
 /* Store Magic String */
 Status encode_magic_string(const char *magic_string, EncodeInfo *encInfo);
@@ -74,8 +123,14 @@ Status encode_secret_file_size(int file_size, EncodeInfo *encInfo);
 /* Encode secret file data*/
 Status encode_secret_file_data(EncodeInfo *encInfo);
 
+/* Embed the files of an archive, then its table of contents */
+Status encode_archive_data(EncodeInfo *encInfo);
+
+/* Encode the CRC32C trailer of the data */
+Status encode_secret_file_crc(EncodeInfo *encInfo);
+
 /* Encode function, which does the real encoding */
-Status encode_data_to_image(const char *data, int size, FILE *fptr_src_image, FILE *fptr_stego_image);
+Status encode_data_to_image(const char *data, long size, LsbEngine *engine);
 
 /* Encode a byte into LSB of image data array */
 Status encode_byte_to_lsb(char data, char *image_buffer);
@@ -85,7 +140,7 @@ Status encode_int_to_lsb(int data, char *imgage_buffer);
 Status encode_secret_file_extn_size(int extn_size, EncodeInfo *encoInfo);
 
 /* Copy remaining image bytes from src to stego image after encoding */
-Status copy_remaining_img_data(FILE *fptr_src, FILE *fptr_dest);
+Status copy_remaining_img_data(LsbEngine *engine);
 
 /*Closing the opening files for encoding*/
 void close_encode_files(EncodeInfo *encInfo);
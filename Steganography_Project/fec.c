@@ -0,0 +1,314 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - Reed-Solomon forward error correction
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "fec.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define FEC_X86 1
+#endif
+
+#define GF_POLY 0x11D
+
+// Parity rows of the FEC_K data rows at the start of stripe
+typedef void (*ParityRowsFn)(const unsigned char *stripe, unsigned char *parity);
+
+static ParityRowsFn parity_rows;
+
+static unsigned char gf_exp[2 * FEC_N];
+static unsigned char gf_log[256];
+
+// g(x) = (x + 1)(x + a)...(x + a^31) below its leading x^32: generator[i] multiplies x^i
+static unsigned char generator[FEC_PARITY];
+
+// Products of each generator coefficient with every low and high nibble, twice over so a
+// 256-bit shuffle finds the table in both of its lanes
+static unsigned char gen_lo[FEC_PARITY][32] __attribute__((aligned(32)));
+static unsigned char gen_hi[FEC_PARITY][32] __attribute__((aligned(32)));
+
+static unsigned char gf_mul(unsigned char a, unsigned char b)
+{
+    if (a == 0 || b == 0)
+        return 0;
+    return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+static unsigned char gf_div(unsigned char a, unsigned char b)
+{
+    if (a == 0)
+        return 0;
+    return gf_exp[gf_log[a] + FEC_N - gf_log[b]];
+}
+
+// a^(e * i) for the Chien search and Forney, exponents kept below FEC_N
+static unsigned char gf_pow(int e, int i)
+{
+    return gf_exp[(e * i) % FEC_N];
+}
+
+// One shift register per codeword: each data byte, added to the top register, feeds the
+// generator's coefficients back into the others
+static void parity_rows_scalar(const unsigned char *stripe, unsigned char *parity)
+{
+    unsigned char p[FEC_PARITY], fb;
+    int lane, s, k;
+
+    for (lane = 0; lane < FEC_DEPTH; lane++)
+    {
+        memset(p, 0, sizeof(p));
+        for (s = 0; s < FEC_K; s++)
+        {
+            fb = stripe[s * FEC_DEPTH + lane] ^ p[0];
+            for (k = 0; k < FEC_PARITY - 1; k++)
+                p[k] = p[k + 1] ^ gf_mul(fb, generator[FEC_PARITY - 1 - k]);
+            p[FEC_PARITY - 1] = gf_mul(fb, generator[0]);
+        }
+        for (k = 0; k < FEC_PARITY; k++)
+            parity[k * FEC_DEPTH + lane] = p[k];
+    }
+}
+
+#ifdef FEC_X86
+// Feedback times generator[i]: one table lookup per nibble, both with PSHUFB
+#define MUL_SSSE3(lo, hi, i)                                                               \
+    _mm_xor_si128(_mm_shuffle_epi8(_mm_load_si128((const __m128i *)gen_lo[i]), lo),      \
+                  _mm_shuffle_epi8(_mm_load_si128((const __m128i *)gen_hi[i]), hi))
+
+// SSSE3: the registers of 16 codewords side by side, the stripe in two halves
+__attribute__((target("ssse3"))) static void parity_rows_ssse3(const unsigned char *stripe, unsigned char *parity)
+{
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i p[FEC_PARITY], fb, lo, hi;
+    int half, s, k;
+
+    for (half = 0; half < FEC_DEPTH; half += 16)
+    {
+        for (k = 0; k < FEC_PARITY; k++)
+            p[k] = _mm_setzero_si128();
+        for (s = 0; s < FEC_K; s++)
+        {
+            fb = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(stripe + s * FEC_DEPTH + half)), p[0]);
+            lo = _mm_and_si128(fb, mask);
+            hi = _mm_and_si128(_mm_srli_epi16(fb, 4), mask);
+            for (k = 0; k < FEC_PARITY - 1; k++)
+                p[k] = _mm_xor_si128(p[k + 1], MUL_SSSE3(lo, hi, FEC_PARITY - 1 - k));
+            p[FEC_PARITY - 1] = MUL_SSSE3(lo, hi, 0);
+        }
+        for (k = 0; k < FEC_PARITY; k++)
+            _mm_storeu_si128((__m128i *)(parity + k * FEC_DEPTH + half), p[k]);
+    }
+}
+
+#define MUL_AVX2(lo, hi, i)                                                                      \
+    _mm256_xor_si256(_mm256_shuffle_epi8(_mm256_load_si256((const __m256i *)gen_lo[i]), lo),    \
+                     _mm256_shuffle_epi8(_mm256_load_si256((const __m256i *)gen_hi[i]), hi))
+
+// AVX2: a whole row, all FEC_DEPTH codewords, per step
+__attribute__((target("avx2"))) static void parity_rows_avx2(const unsigned char *stripe, unsigned char *parity)
+{
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    __m256i p[FEC_PARITY], fb, lo, hi;
+    int s, k;
+
+    for (k = 0; k < FEC_PARITY; k++)
+        p[k] = _mm256_setzero_si256();
+    for (s = 0; s < FEC_K; s++)
+    {
+        fb = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(stripe + s * FEC_DEPTH)), p[0]);
+        lo = _mm256_and_si256(fb, mask);
+        hi = _mm256_and_si256(_mm256_srli_epi16(fb, 4), mask);
+        for (k = 0; k < FEC_PARITY - 1; k++)
+            p[k] = _mm256_xor_si256(p[k + 1], MUL_AVX2(lo, hi, FEC_PARITY - 1 - k));
+        p[FEC_PARITY - 1] = MUL_AVX2(lo, hi, 0);
+    }
+    for (k = 0; k < FEC_PARITY; k++)
+        _mm256_storeu_si256((__m256i *)(parity + k * FEC_DEPTH), p[k]);
+}
+#endif
+
+void fec_encode(unsigned char *stripe)
+{
+    parity_rows(stripe, stripe + FEC_STRIPE_DATA);
+}
+
+// r(a^i) for i below FEC_PARITY, byte 0 being the highest power; all zero for a codeword
+static int syndromes(const unsigned char *r, unsigned char *syn)
+{
+    int i, s, nonzero = 0;
+
+    for (i = 0; i < FEC_PARITY; i++)
+    {
+        syn[i] = 0;
+        for (s = 0; s < FEC_N; s++)
+            syn[i] = gf_mul(syn[i], gf_exp[i]) ^ r[s];
+        nonzero |= syn[i];
+    }
+    return nonzero;
+}
+
+// Berlekamp-Massey for the error locator, a Chien search for its roots and Forney for
+// the error values; the bytes fixed in codeword lane, -1 when there are too many
+static int correct_codeword(unsigned char *stripe, int lane)
+{
+    unsigned char r[FEC_N], syn[FEC_PARITY], omega[FEC_PARITY];
+    unsigned char lambda[FEC_PARITY + 1], prev[FEC_PARITY + 1], saved[FEC_PARITY + 1];
+    unsigned char d, b = 1, num, den;
+    int where[FEC_PARITY / 2];
+    int i, j, n, s, e, inv, L = 0, m = 1, count = 0;
+
+    for (s = 0; s < FEC_N; s++)
+        r[s] = stripe[s * FEC_DEPTH + lane];
+    if (!syndromes(r, syn))
+        return 0;
+
+    memset(lambda, 0, sizeof(lambda));
+    memset(prev, 0, sizeof(prev));
+    lambda[0] = prev[0] = 1;
+    for (n = 0; n < FEC_PARITY; n++)
+    {
+        d = syn[n];
+        for (i = 1; i <= L; i++)
+            d ^= gf_mul(lambda[i], syn[n - i]);
+        if (d == 0)
+        {
+            m++;
+            continue;
+        }
+        memcpy(saved, lambda, sizeof(saved));
+        for (i = 0; i + m <= FEC_PARITY; i++)
+            lambda[i + m] ^= gf_mul(gf_div(d, b), prev[i]);
+        if (2 * L <= n)
+        {
+            L = n + 1 - L;
+            memcpy(prev, saved, sizeof(prev));
+            b = d;
+            m = 1;
+        }
+        else
+        {
+            m++;
+        }
+    }
+    if (L > FEC_PARITY / 2)
+        return -1;
+
+    // Byte s has degree e = FEC_N - 1 - s: it is wrong when a^-e is a root of the locator
+    for (s = 0; s < FEC_N && count <= L; s++)
+    {
+        inv = (FEC_N - (FEC_N - 1 - s)) % FEC_N;
+        d = 0;
+        for (i = 0; i <= L; i++)
+            d ^= gf_mul(lambda[i], gf_pow(inv, i));
+        if (d == 0 && count < L)
+            where[count] = s;
+        count += d == 0;
+    }
+    if (count != L)
+        return -1;
+
+    // Omega = S * Lambda mod x^FEC_PARITY; with first root 1 the value is X * Omega / Lambda'
+    for (i = 0; i < FEC_PARITY; i++)
+    {
+        omega[i] = 0;
+        for (j = 0; j <= i && j <= L; j++)
+            omega[i] ^= gf_mul(syn[i - j], lambda[j]);
+    }
+    for (j = 0; j < count; j++)
+    {
+        e = FEC_N - 1 - where[j];
+        inv = (FEC_N - e) % FEC_N;
+        num = den = 0;
+        for (i = 0; i < FEC_PARITY; i++)
+            num ^= gf_mul(omega[i], gf_pow(inv, i));
+        for (i = 1; i <= L; i += 2)
+            den ^= gf_mul(lambda[i], gf_pow(inv, i - 1));
+        if (den == 0)
+            return -1;
+        r[where[j]] ^= gf_mul(gf_exp[e], gf_div(num, den));
+    }
+
+    // Only a result that is a codeword again goes back into the stripe
+    if (syndromes(r, syn))
+        return -1;
+    for (j = 0; j < count; j++)
+        stripe[where[j] * FEC_DEPTH + lane] = r[where[j]];
+    return count;
+}
+
+long fec_decode(unsigned char *stripe)
+{
+    unsigned char parity[FEC_PARITY * FEC_DEPTH];
+    long fixed = 0;
+    int lane, k, n;
+
+    // Parity of the data rows as read: a codeword whose parity rows agree is clean
+    parity_rows(stripe, parity);
+    if (memcmp(parity, stripe + FEC_STRIPE_DATA, sizeof(parity)) == 0)
+        return 0;
+
+    for (lane = 0; lane < FEC_DEPTH; lane++)
+    {
+        for (k = 0; k < FEC_PARITY; k++)
+        {
+            if (parity[k * FEC_DEPTH + lane] != stripe[FEC_STRIPE_DATA + k * FEC_DEPTH + lane])
+                break;
+        }
+        if (k == FEC_PARITY)
+            continue;
+        n = correct_codeword(stripe, lane);
+        if (n < 0)
+            return -1;
+        fixed += n;
+    }
+    return fixed;
+}
+
+// Field tables, the generator and its nibble tables, then the widest row coder this CPU runs
+__attribute__((constructor)) static void fec_init(void)
+{
+    unsigned char g[FEC_PARITY + 1] = {1};
+    unsigned x = 1;
+    int i, j;
+
+    for (i = 0; i < FEC_N; i++)
+    {
+        gf_exp[i] = gf_exp[i + FEC_N] = x;
+        gf_log[x] = i;
+        x <<= 1;
+        if (x & 0x100)
+            x ^= GF_POLY;
+    }
+
+    // Multiply in (x + a^i) one root at a time
+    for (i = 0; i < FEC_PARITY; i++)
+    {
+        for (j = i + 1; j > 0; j--)
+            g[j] = g[j - 1] ^ gf_mul(g[j], gf_exp[i]);
+        g[0] = gf_mul(g[0], gf_exp[i]);
+    }
+    for (i = 0; i < FEC_PARITY; i++)
+    {
+        generator[i] = g[i];
+        for (j = 0; j < 16; j++)
+        {
+            gen_lo[i][j] = gen_lo[i][j + 16] = gf_mul(g[i], j);
+            gen_hi[i][j] = gen_hi[i][j + 16] = gf_mul(g[i], j << 4);
+        }
+    }
+
+    // Log/exp tables only under STEGO_KERNEL=scalar
+    parity_rows = parity_rows_scalar;
+    if (getenv("STEGO_KERNEL") != NULL && strcmp(getenv("STEGO_KERNEL"), "scalar") == 0)
+        return;
+#ifdef FEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        parity_rows = parity_rows_avx2;
+    else if (__builtin_cpu_supports("ssse3"))
+        parity_rows = parity_rows_ssse3;
+#endif
+}
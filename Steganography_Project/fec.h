@@ -0,0 +1,34 @@
+#ifndef FEC_H
+#define FEC_H
+
+#include "types.h" // Contains user defined types
+
+/*
+ * Reed-Solomon forward error correction
+ * RS(255, 223) over GF(2^8) (polynomial 0x11d, first root 1) corrects up
+ * to 16 wrong bytes per codeword. FEC_DEPTH codewords are interleaved
+ * into a stripe: row s holds byte s of every codeword, so the first
+ * FEC_K rows are the data as it is and the last FEC_PARITY rows the
+ * parity, and a run of flipped carrier bytes is shared out over all of
+ * them. Rows are coded FEC_DEPTH bytes at a time with split-nibble
+ * PSHUFB multiplies (AVX2, else SSSE3), log/exp tables otherwise or
+ * under STEGO_KERNEL=scalar.
+ */
+
+#define FEC_N 255
+#define FEC_K 223
+#define FEC_PARITY (FEC_N - FEC_K)
+#define FEC_DEPTH 32
+#define FEC_STRIPE_DATA (FEC_K * FEC_DEPTH)
+#define FEC_STRIPE_SIZE (FEC_N * FEC_DEPTH)
+
+/* Bytes size data bytes take once coded: whole stripes, the last one padded with zeros */
+#define FEC_CODED_SIZE(size) (((size) + FEC_STRIPE_DATA - 1) / FEC_STRIPE_DATA * FEC_STRIPE_SIZE)
+
+/* Fill the parity rows of stripe from its data rows */
+void fec_encode(unsigned char *stripe);
+
+/* Correct stripe in place; the bytes put right, or -1 when a codeword has too many errors */
+long fec_decode(unsigned char *stripe);
+
+#endif
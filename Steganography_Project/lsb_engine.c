@@ -0,0 +1,809 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - block-buffered LSB engine
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include "lsb_engine.h"
+#include "lsb_kernels.h"
+#include "crc32c.h"
+#include "encode.h"
+#include "decode.h"
+#include "types.h"
+
+// State both init calls share: 1-bit kernel, carrier byte 0, no CRC
+static void reset_engine(LsbEngine *engine)
+{
+    engine->map = NULL;
+    engine->map_size = 0;
+    engine->offset = 0;
+    engine->released = 0;
+    engine->pos = 0;
+    engine->span = NULL;
+    engine->span_pos = engine->span_from = engine->span_to = 0;
+    engine->scatter.order = NULL;
+    engine->kernel = lsb_kernel();
+    engine->track_crc = 0;
+    engine->crc = 0;
+    engine->fd_patch = -1;
+    engine->patch_bytes = engine->patch_writes = 0;
+    engine->head = NULL;
+    engine->fec = NULL;
+    engine->fec_fill = engine->fec_left = engine->fec_corrected = 0;
+    engine->fec_lost = 0;
+}
+
+// Use layout; gaps between carrier bytes need a buffer to assemble each span in
+Status lsb_engine_set_layout(LsbEngine *engine, const BmpLayout *layout)
+{
+    engine->layout = *layout;
+    if (layout->packed || engine->span != NULL)
+        return e_success;
+    engine->span = malloc(BMP_SPAN_SIZE(LSB_CARRIER_BLOCK));
+    return engine->span != NULL ? e_success : e_failure;
+}
+
+// Attach the engine to the carrier streams and allocate the staging block
+Status lsb_engine_init(LsbEngine *engine, FILE *fptr_src, FILE *fptr_dest, const BmpLayout *layout)
+{
+    struct stat st;
+    void *map;
+
+    engine->fptr_src = fptr_src;
+    engine->fptr_dest = fptr_dest;
+    engine->owns_map = 1;
+    engine->out = NULL;
+    reset_engine(engine);
+    engine->block = malloc(LSB_CARRIER_BLOCK);
+    if (engine->block == NULL || lsb_engine_set_layout(engine, layout) == e_failure)
+    {
+        return e_failure;
+    }
+
+    // Map regular files so carrier bytes are read straight from the page cache
+    if (fstat(fileno(fptr_src), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fptr_src), 0);
+        if (map != MAP_FAILED)
+        {
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            engine->map = map;
+            engine->map_size = st.st_size;
+            engine->offset = ftell(fptr_src);
+        }
+    }
+    return e_success;
+}
+
+// From now on write into the source itself: the mapping still holds what each span was
+Status lsb_engine_patch_source(LsbEngine *engine)
+{
+    if (engine->map == NULL || !engine->owns_map)
+        return e_failure;
+    engine->fd_patch = fileno(engine->fptr_src);
+    return e_success;
+}
+
+// Spans are visited out of file order from here on, so the destination cannot be appended to:
+// it gets the rest of the source now and each span is patched into it
+Status lsb_engine_scatter(LsbEngine *engine, const unsigned char key[AEAD_KEY_SIZE])
+{
+    if (engine->map == NULL)
+        return e_failure;
+    if (engine->fd_patch < 0 && (engine->out != NULL || engine->fptr_dest != NULL))
+    {
+        if (lsb_engine_copy_rest(engine) == e_failure)
+            return e_failure;
+        if (engine->out == NULL)
+            engine->fd_patch = fileno(engine->fptr_dest);
+    }
+    if (scatter_init(&engine->scatter, key, engine->pos, engine->layout.usable) == e_failure)
+        return e_failure;
+
+    // Blocks are read whole, but no longer one after the other
+    if (engine->owns_map)
+        madvise((void *)engine->map, engine->map_size, MADV_NORMAL);
+    return e_success;
+}
+
+// Headers were read off a stream: they stand in for the bytes a seek back would fetch
+void lsb_engine_set_head(LsbEngine *engine, unsigned char *head)
+{
+    free(engine->head);
+    engine->head = head;
+    engine->offset = engine->layout.offset;
+}
+
+// Use caller buffers as the carrier: no stdio, no mapping of our own
+Status lsb_engine_init_mem(LsbEngine *engine, const unsigned char *src, long size, unsigned char *out,
+                           const BmpLayout *layout)
+{
+    engine->fptr_src = NULL;
+    engine->fptr_dest = NULL;
+    engine->owns_map = 0;
+    engine->out = out;
+    reset_engine(engine);
+    engine->map = src;
+    engine->map_size = size;
+    engine->block = malloc(LSB_CARRIER_BLOCK);
+    if (engine->block == NULL || lsb_engine_set_layout(engine, layout) == e_failure)
+    {
+        return e_failure;
+    }
+    return e_success;
+}
+
+// Drop consumed map pages so resident memory stays bounded on big images
+static void release_consumed(LsbEngine *engine)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    long end = engine->offset & ~(page - 1);
+
+    // A caller's buffer is not ours to discard, and scattered spans are dropped one by one
+    if (!engine->owns_map || engine->scatter.order != NULL)
+        return;
+
+    if (engine->offset < engine->released)
+        engine->released = end;
+    if (end - engine->released < LSB_CARRIER_BLOCK)
+        return;
+
+    // Clean private pages: they come back from the page cache if touched again
+    madvise((void *)(engine->map + engine->released), end - engine->released, MADV_DONTNEED);
+    engine->released = end;
+}
+
+// Scattered spans are visited once each: drop the whole pages of the last one
+static void release_span(LsbEngine *engine)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    long from = (engine->span_from + page - 1) & ~(page - 1);
+    long to = engine->span_to & ~(page - 1);
+
+    if (engine->owns_map && to > from)
+        madvise((void *)(engine->map + from), to - from, MADV_DONTNEED);
+}
+
+// Get the next size carrier bytes: straight from the mapping or the block when the
+// layout is packed, else gathered out of their span into the block
+static const unsigned char *read_carrier(LsbEngine *engine, long size)
+{
+    const unsigned char *span;
+    unsigned char *buf;
+    long pos = engine->pos;
+
+    if (pos < 0 || pos + size > engine->layout.usable)
+        return NULL;
+
+    // Scattered data: the bytes lie inside one block, wherever the key put it
+    if (engine->scatter.order != NULL && pos >= engine->scatter.start)
+    {
+        if (size > scatter_run(&engine->scatter, pos))
+            return NULL;
+        release_span(engine);
+        pos = scatter_pos(&engine->scatter, pos);
+    }
+    engine->span_pos = pos;
+    engine->span_from = bmp_offset(&engine->layout, pos);
+    engine->span_to = bmp_offset(&engine->layout, pos + size);
+
+    if (engine->map != NULL)
+    {
+        if (engine->span_to > engine->map_size)
+            return NULL;
+        engine->offset = engine->span_from;
+        release_consumed(engine);
+        span = engine->map + engine->span_from;
+    }
+    else
+    {
+        // Sequential stdio: the file position is already at span_from
+        buf = engine->layout.packed ? (unsigned char *)engine->block : engine->span;
+        if (fread(buf, 1, engine->span_to - engine->span_from, engine->fptr_src) !=
+            (size_t)(engine->span_to - engine->span_from))
+            return NULL;
+        span = buf;
+    }
+    engine->offset = engine->span_to;
+    engine->pos += size;
+
+    if (engine->layout.packed)
+        return span;
+    bmp_gather(&engine->layout, pos, size, span, (unsigned char *)engine->block);
+    return (const unsigned char *)engine->block;
+}
+
+// Where the kernel puts the modified carrier of the block just read
+static unsigned char *carrier_dest(LsbEngine *engine)
+{
+    if (engine->out != NULL && engine->layout.packed)
+        return engine->out + engine->span_from;
+    return (unsigned char *)engine->block;
+}
+
+// In place: pwrite only the runs of the new span that differ from the file, a run taking in
+// gaps of unchanged bytes shorter than LSB_PATCH_GAP
+static Status patch_carrier(LsbEngine *engine, const unsigned char *carrier, long size)
+{
+    const unsigned char *old = engine->map + engine->span_from;
+    const unsigned char *span = carrier;
+    long length = engine->span_to - engine->span_from;
+    long i = 0, first, last;
+
+    if (!engine->layout.packed)
+    {
+        memcpy(engine->span, old, length);
+        bmp_scatter(&engine->layout, engine->span_pos, size, carrier, engine->span);
+        span = engine->span;
+    }
+
+    while (i < length)
+    {
+        while (i < length && span[i] == old[i])
+            i++;
+        if (i == length)
+            break;
+        first = last = i;
+        for (i++; i < length && i - last <= LSB_PATCH_GAP; i++)
+        {
+            if (span[i] != old[i])
+                last = i;
+        }
+        if (lsb_pwrite_full(engine->fd_patch, span + first, last + 1 - first, engine->span_from + first) == e_failure)
+            return e_failure;
+        engine->patch_bytes += last + 1 - first;
+        engine->patch_writes++;
+        i = last + 1;
+    }
+    return e_success;
+}
+
+// Store the span of the block just read, its size carrier bytes replaced by carrier
+static Status write_carrier(LsbEngine *engine, const unsigned char *carrier, long size)
+{
+    long length = engine->span_to - engine->span_from;
+    unsigned char *span;
+
+    if (engine->fd_patch >= 0)
+        return patch_carrier(engine, carrier, size);
+
+    if (engine->layout.packed)
+    {
+        if (engine->out == NULL)
+            return fwrite(carrier, 1, length, engine->fptr_dest) == (size_t)length ? e_success : e_failure;
+        if (carrier != engine->out + engine->span_from)
+            memcpy(engine->out + engine->span_from, carrier, length);
+        return e_success;
+    }
+
+    // Padding and fourth pixel bytes go out as they came in (stdio already read them into span)
+    span = engine->out != NULL ? engine->out + engine->span_from : engine->span;
+    if (engine->map != NULL)
+        memcpy(span, engine->map + engine->span_from, length);
+    bmp_scatter(&engine->layout, engine->span_pos, size, carrier, span);
+    if (engine->out != NULL)
+        return e_success;
+    return fwrite(span, 1, length, engine->fptr_dest) == (size_t)length ? e_success : e_failure;
+}
+
+// Switch the payload density; header fields keep using their own 1-bit helpers
+Status lsb_engine_set_bits(LsbEngine *engine, int bits)
+{
+    const LsbKernel *kernel = lsb_kernel_bits(bits);
+
+    if (kernel == NULL)
+        return e_failure;
+    engine->kernel = kernel;
+    return e_success;
+}
+
+// Checksum the data stage as it goes through, so nothing is read twice
+void lsb_engine_track_crc(LsbEngine *engine, int on)
+{
+    if (on)
+        engine->crc = 0;
+    engine->track_crc = on;
+}
+
+// Worker threads checksummed their slices: fold the result in
+void lsb_engine_add_crc(LsbEngine *engine, uint32_t crc, long size)
+{
+    engine->crc = crc32c_combine(engine->crc, crc, size);
+}
+
+// Move the read position to carrier byte pos
+Status lsb_engine_seek(LsbEngine *engine, long pos)
+{
+    long offset = bmp_offset(&engine->layout, scatter_pos(&engine->scatter, pos)), chunk;
+
+    if (engine->map == NULL && engine->head != NULL)
+    {
+        // A stream only goes forward: read past the skipped bytes
+        if (offset < engine->offset)
+            return e_failure;
+        for (; engine->offset < offset; engine->offset += chunk)
+        {
+            chunk = offset - engine->offset > LSB_CARRIER_BLOCK ? LSB_CARRIER_BLOCK : offset - engine->offset;
+            if (fread(engine->block, 1, chunk, engine->fptr_src) != (size_t)chunk)
+                return e_failure;
+        }
+        engine->pos = pos;
+        return e_success;
+    }
+
+    engine->pos = pos;
+    engine->offset = offset;
+    if (engine->map != NULL)
+        return e_success;
+    return fseek(engine->fptr_src, engine->offset, SEEK_SET) == 0 ? e_success : e_failure;
+}
+
+// Copy the headers, palette and gap before the pixel array as they are
+Status lsb_engine_copy_header(LsbEngine *engine)
+{
+    long size = engine->layout.offset, chunk;
+
+    if (engine->fd_patch >= 0)
+        return lsb_engine_seek(engine, 0);
+    if (engine->map != NULL)
+    {
+        if (size > engine->map_size)
+            return e_failure;
+        if (engine->out != NULL)
+            memcpy(engine->out, engine->map, size);
+        else if (fwrite(engine->map, 1, size, engine->fptr_dest) != (size_t)size)
+            return e_failure;
+        return lsb_engine_seek(engine, 0);
+    }
+
+    // A stream is already past its headers: they were kept for this
+    if (engine->head != NULL)
+    {
+        if (fwrite(engine->head, 1, size, engine->fptr_dest) != (size_t)size)
+            return e_failure;
+        engine->pos = 0;
+        engine->offset = engine->layout.offset;
+        return e_success;
+    }
+
+    if (fseek(engine->fptr_src, 0, SEEK_SET) != 0)
+        return e_failure;
+    for (; size > 0; size -= chunk)
+    {
+        chunk = size > LSB_CARRIER_BLOCK ? LSB_CARRIER_BLOCK : size;
+        if (fread(engine->block, 1, chunk, engine->fptr_src) != (size_t)chunk ||
+            fwrite(engine->block, 1, chunk, engine->fptr_dest) != (size_t)chunk)
+            return e_failure;
+    }
+    engine->pos = 0;
+    engine->offset = engine->layout.offset;
+    return e_success;
+}
+
+// Payload bytes of the next chunk out of left: a block at most, and never across two scatter blocks
+static long next_chunk(LsbEngine *engine, long left)
+{
+    long run = scatter_run(&engine->scatter, engine->pos);
+
+    if (left > LSB_PAYLOAD_BLOCK)
+        left = LSB_PAYLOAD_BLOCK;
+    if (run < LSB_CARRIER_BLOCK && run > 0 && left > run * engine->kernel->bits / 8)
+        left = run * engine->kernel->bits / 8;
+    return left;
+}
+
+// Embed data block by block: one read and one fwrite per LSB_CARRIER_BLOCK
+static Status embed_carrier(LsbEngine *engine, const unsigned char *data, long size)
+{
+    const LsbKernel *kernel = engine->kernel;
+    const unsigned char *carrier;
+    unsigned char *dest;
+    long done = 0, chunk, bytes;
+
+    while (done < size)
+    {
+        chunk = next_chunk(engine, size - done);
+        bytes = LSB_CARRIER_SIZE(chunk, kernel->bits);
+
+        // Fetch the carrier bytes for this chunk in one go
+        carrier = read_carrier(engine, bytes);
+        if (carrier == NULL)
+            return e_failure;
+
+        // Modify LSBs, 8 / bits carrier bytes per payload byte (straight into an output buffer)
+        dest = carrier_dest(engine);
+        kernel->embed(dest, carrier, data + done, chunk);
+
+        if (write_carrier(engine, dest, bytes) == e_failure)
+            return e_failure;
+
+        done += chunk;
+    }
+    return e_success;
+}
+
+// Embed a 32-bit integer into the next 32 carrier bytes
+Status lsb_engine_embed_int(LsbEngine *engine, int value)
+{
+    const unsigned char *carrier = read_carrier(engine, 32);
+
+    if (carrier == NULL)
+        return e_failure;
+    if (carrier != (const unsigned char *)engine->block)
+        memcpy(engine->block, carrier, 32);
+
+    encode_int_to_lsb(value, engine->block);
+
+    return write_carrier(engine, (unsigned char *)engine->block, 32);
+}
+
+// Extract data block by block: one read per LSB_CARRIER_BLOCK
+static Status extract_carrier(LsbEngine *engine, unsigned char *data, long size)
+{
+    const LsbKernel *kernel = engine->kernel;
+    const unsigned char *carrier;
+    long done = 0, chunk;
+
+    while (done < size)
+    {
+        chunk = next_chunk(engine, size - done);
+
+        carrier = read_carrier(engine, LSB_CARRIER_SIZE(chunk, kernel->bits));
+        if (carrier == NULL)
+            return e_failure;
+
+        // Gather LSBs, 8 / bits carrier bytes per payload byte
+        kernel->extract(data + done, carrier, chunk);
+
+        done += chunk;
+    }
+    return e_success;
+}
+
+// A full stripe: its parity rows, then all of it into the carrier
+static Status embed_stripe(LsbEngine *engine)
+{
+    fec_encode(engine->fec);
+    engine->fec_fill = 0;
+    return embed_carrier(engine, engine->fec, FEC_STRIPE_SIZE);
+}
+
+// The next stripe out of the carrier, corrected
+static Status extract_stripe(LsbEngine *engine)
+{
+    long fixed;
+
+    if (extract_carrier(engine, engine->fec, FEC_STRIPE_SIZE) == e_failure)
+        return e_failure;
+    fixed = fec_decode(engine->fec);
+    if (fixed < 0)
+    {
+        engine->fec_lost = 1;
+        return e_failure;
+    }
+    engine->fec_corrected += fixed;
+    engine->fec_left = FEC_STRIPE_DATA;
+    return e_success;
+}
+
+Status lsb_engine_embed(LsbEngine *engine, const char *data, long size)
+{
+    long done, chunk;
+
+    if (engine->track_crc)
+        engine->crc = crc32c_update(engine->crc, data, size);
+    if (engine->fec == NULL)
+        return embed_carrier(engine, (const unsigned char *)data, size);
+
+    // Gather a stripe's worth of data before any of it goes in
+    for (done = 0; done < size; done += chunk)
+    {
+        chunk = FEC_STRIPE_DATA - engine->fec_fill;
+        if (chunk > size - done)
+            chunk = size - done;
+        memcpy(engine->fec + engine->fec_fill, data + done, chunk);
+        engine->fec_fill += chunk;
+        if (engine->fec_fill == FEC_STRIPE_DATA && embed_stripe(engine) == e_failure)
+            return e_failure;
+    }
+    return e_success;
+}
+
+Status lsb_engine_extract(LsbEngine *engine, char *data, long size)
+{
+    long done, chunk;
+
+    if (engine->fec == NULL)
+    {
+        if (extract_carrier(engine, (unsigned char *)data, size) == e_failure)
+            return e_failure;
+    }
+    else
+    {
+        for (done = 0; done < size; done += chunk)
+        {
+            if (engine->fec_left == 0 && extract_stripe(engine) == e_failure)
+                return e_failure;
+            chunk = engine->fec_left < size - done ? engine->fec_left : size - done;
+            memcpy(data + done, engine->fec + FEC_STRIPE_DATA - engine->fec_left, chunk);
+            engine->fec_left -= chunk;
+        }
+    }
+    if (engine->track_crc)
+        engine->crc = crc32c_update(engine->crc, data, size);
+    return e_success;
+}
+
+// Coding on allocates the stripe; off embeds what was gathered, zero padded
+Status lsb_engine_set_fec(LsbEngine *engine, int on)
+{
+    Status ret = e_success;
+
+    if (on)
+    {
+        if (engine->fec == NULL)
+            engine->fec = malloc(FEC_STRIPE_SIZE);
+        engine->fec_fill = engine->fec_left = 0;
+        return engine->fec != NULL ? e_success : e_failure;
+    }
+    if (engine->fec != NULL && engine->fec_fill > 0)
+    {
+        memset(engine->fec + engine->fec_fill, 0, FEC_STRIPE_DATA - engine->fec_fill);
+        ret = embed_stripe(engine);
+    }
+    free(engine->fec);
+    engine->fec = NULL;
+    return ret;
+}
+
+// Gathered bytes count too: they go in with the stripe they are waiting for
+long lsb_engine_carrier_for(LsbEngine *engine, long size)
+{
+    if (engine->fec == NULL)
+        return LSB_CARRIER_SIZE(size, engine->kernel->bits);
+    return LSB_CARRIER_SIZE(FEC_CODED_SIZE(engine->fec_fill + size), engine->kernel->bits);
+}
+
+// Extract a 32-bit integer from the next 32 carrier bytes
+Status lsb_engine_extract_int(LsbEngine *engine, int *value)
+{
+    const unsigned char *carrier = read_carrier(engine, 32);
+
+    if (carrier == NULL)
+        return e_failure;
+
+    decode_int_from_lsb(value, (char *)carrier);
+    return e_success;
+}
+
+// Current carrier read position
+long lsb_engine_tell(LsbEngine *engine)
+{
+    return engine->pos;
+}
+
+// Carrier bytes were handled positionally by worker threads: step over them
+Status lsb_engine_skip(LsbEngine *engine, long size)
+{
+    if (lsb_engine_seek(engine, engine->pos + size) == e_failure)
+        return e_failure;
+    if (engine->fptr_dest != NULL &&
+        (fflush(engine->fptr_dest) != 0 || fseek(engine->fptr_dest, engine->offset, SEEK_SET) != 0))
+        return e_failure;
+    return e_success;
+}
+
+// Copy every carrier byte left after the payload, in the kernel when possible
+Status lsb_engine_copy_rest(LsbEngine *engine)
+{
+    int fd_src, fd_dest;
+    off_t offset;
+    ssize_t n;
+    size_t left;
+
+    // In place the rest of the image is already where it belongs, and scattering copied it up front
+    if (engine->fd_patch >= 0 || engine->scatter.order != NULL)
+        return e_success;
+    if (engine->out != NULL)
+    {
+        memcpy(engine->out + engine->offset, engine->map + engine->offset, engine->map_size - engine->offset);
+        engine->offset = engine->map_size;
+        return e_success;
+    }
+
+    if (engine->map == NULL)
+    {
+        // Not seekable as a file: plain buffered copy
+        while ((n = fread(engine->block, 1, LSB_CARRIER_BLOCK, engine->fptr_src)) > 0)
+        {
+            if (fwrite(engine->block, 1, n, engine->fptr_dest) != (size_t)n)
+                return e_failure;
+        }
+        return ferror(engine->fptr_src) ? e_failure : e_success;
+    }
+
+    // Everything buffered so far must reach the fd before the kernel appends
+    if (fflush(engine->fptr_dest) != 0)
+        return e_failure;
+    fd_src = fileno(engine->fptr_src);
+    fd_dest = fileno(engine->fptr_dest);
+
+    offset = engine->offset;
+    left = engine->map_size - engine->offset;
+
+    // copy_file_range keeps the data inside the kernel (reflinks on some filesystems)
+    while (left > 0)
+    {
+        n = copy_file_range(fd_src, &offset, fd_dest, NULL, left, 0);
+        if (n <= 0)
+            break;
+        left -= n;
+    }
+
+    // Cross-filesystem or older kernels: sendfile still avoids user space
+    while (left > 0)
+    {
+        n = sendfile(fd_dest, fd_src, &offset, left);
+        if (n <= 0)
+            break;
+        left -= n;
+    }
+
+    // Last resort: large writes straight from the mapping
+    if (left > 0)
+    {
+        if (fwrite(engine->map + offset, 1, left, engine->fptr_dest) != left)
+            return e_failure;
+        offset += left;
+    }
+
+    engine->offset = offset;
+    return e_success;
+}
+
+// pread until size bytes arrived
+Status lsb_pread_full(int fd, void *buf, long size, long offset)
+{
+    ssize_t n;
+
+    while (size > 0)
+    {
+        n = pread(fd, buf, size, offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return e_failure;
+        buf = (char *)buf + n;
+        size -= n;
+        offset += n;
+    }
+    return e_success;
+}
+
+// pwrite until size bytes are written
+Status lsb_pwrite_full(int fd, const void *buf, long size, long offset)
+{
+    ssize_t n;
+
+    while (size > 0)
+    {
+        n = pwrite(fd, buf, size, offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return e_failure;
+        buf = (const char *)buf + n;
+        size -= n;
+        offset += n;
+    }
+    return e_success;
+}
+
+// Embed data into a mapped carrier region and pwrite its spans to the same offsets
+Status lsb_embed_at(const unsigned char *map, const BmpLayout *layout, int fd_dest, long pos,
+                    const char *data, long size, int bits, char *block, unsigned char *span, uint32_t *crc)
+{
+    const LsbKernel *kernel = lsb_kernel_bits(bits);
+    long page = sysconf(_SC_PAGESIZE);
+    long done, chunk, bytes, offset, end, from, to;
+    const unsigned char *out = (const unsigned char *)block;
+
+    for (done = 0; done < size; done += chunk)
+    {
+        chunk = size - done;
+        if (chunk > LSB_PAYLOAD_BLOCK)
+            chunk = LSB_PAYLOAD_BLOCK;
+        bytes = LSB_CARRIER_SIZE(chunk, bits);
+        offset = bmp_offset(layout, pos);
+        end = bmp_offset(layout, pos + bytes);
+
+        // Gapped layouts: embed into the gathered carrier, then put it back into a copy of the span
+        if (layout->packed)
+        {
+            kernel->embed((unsigned char *)block, map + offset, (const unsigned char *)data + done, chunk);
+        }
+        else
+        {
+            bmp_gather(layout, pos, bytes, map + offset, (unsigned char *)block);
+            kernel->embed((unsigned char *)block, (const unsigned char *)block, (const unsigned char *)data + done, chunk);
+            memcpy(span, map + offset, end - offset);
+            bmp_scatter(layout, pos, bytes, (const unsigned char *)block, span);
+            out = span;
+        }
+        if (crc != NULL)
+            *crc = crc32c_update(*crc, data + done, chunk);
+        if (lsb_pwrite_full(fd_dest, out, end - offset, offset) == e_failure)
+            return e_failure;
+
+        // Drop the whole pages this chunk consumed from our resident set
+        from = (offset + page - 1) & ~(page - 1);
+        to = end & ~(page - 1);
+        if (to > from)
+            madvise((void *)(map + from), to - from, MADV_DONTNEED);
+
+        pos += bytes;
+    }
+    return e_success;
+}
+
+// pread carrier spans block by block and extract the payload they hold
+Status lsb_extract_at(int fd_src, const BmpLayout *layout, long pos, char *data, long size, int bits,
+                      char *block, unsigned char *span, uint32_t *crc)
+{
+    const LsbKernel *kernel = lsb_kernel_bits(bits);
+    long done, chunk, bytes, offset, end;
+
+    for (done = 0; done < size; done += chunk)
+    {
+        chunk = size - done;
+        if (chunk > LSB_PAYLOAD_BLOCK)
+            chunk = LSB_PAYLOAD_BLOCK;
+        bytes = LSB_CARRIER_SIZE(chunk, bits);
+        offset = bmp_offset(layout, pos);
+        end = bmp_offset(layout, pos + bytes);
+
+        if (layout->packed)
+        {
+            if (lsb_pread_full(fd_src, block, bytes, offset) == e_failure)
+                return e_failure;
+        }
+        else
+        {
+            if (lsb_pread_full(fd_src, span, end - offset, offset) == e_failure)
+                return e_failure;
+            bmp_gather(layout, pos, bytes, span, (unsigned char *)block);
+        }
+        kernel->extract((unsigned char *)data + done, (const unsigned char *)block, chunk);
+        if (crc != NULL)
+            *crc = crc32c_update(*crc, data + done, chunk);
+        pos += bytes;
+    }
+    return e_success;
+}
+
+// Release the staging block and the mapping
+void lsb_engine_free(LsbEngine *engine)
+{
+    free(engine->block);
+    free(engine->span);
+    free(engine->head);
+    free(engine->fec);
+    scatter_free(&engine->scatter);
+    engine->fec = NULL;
+    engine->block = NULL;
+    engine->span = NULL;
+    engine->head = NULL;
+    if (engine->map != NULL && engine->owns_map)
+    {
+        munmap((void *)engine->map, engine->map_size);
+    }
+    engine->map = NULL;
+}
@@ -0,0 +1,170 @@
+#ifndef LSB_ENGINE_H
+#define LSB_ENGINE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "types.h" // Contains user defined types
+#include "lsb_kernels.h"
+#include "bmp.h"
+#include "scatter.h"
+#include "fec.h"
+
+/*
+ * Block-buffered LSB engine
+ * Carrier bytes are moved between the source and stego image
+ * in blocks of LSB_CARRIER_BLOCK bytes, which carry
+ * LSB_PAYLOAD_BLOCK bytes of payload at 1 bit per carrier byte
+ * (and proportionally fewer carrier bytes at 2 or 4 bits).
+ * Positions count carrier bytes from the first pixel (see bmp.h);
+ * each block's span goes to the stego image in one write. Once the
+ * data is scattered (see scatter.h) positions stay those of the data,
+ * and only the spans read and written move.
+ */
+
+#define LSB_CARRIER_BLOCK (1024 * 1024)
+#define LSB_PAYLOAD_BLOCK (LSB_CARRIER_BLOCK / 8)
+
+/* Patching in place: unchanged bytes between two changes are rewritten when fewer than this,
+ * rather than costing another pwrite */
+#define LSB_PATCH_GAP 64
+
+typedef struct
+{
+    FILE *fptr_src;           /* Image the carrier bytes are read from */
+    FILE *fptr_dest;          /* Image the modified bytes go to, NULL while decoding */
+    char *block;              /* Staging buffer of LSB_CARRIER_BLOCK bytes */
+    const LsbKernel *kernel;  /* Packs lsb_engine_embed/extract data, 1 bit until set */
+
+    /* Where the carrier bytes sit in the image */
+    BmpLayout layout;
+    long pos;                 /* Next carrier byte */
+    unsigned char *span;      /* File bytes of one block when the layout has gaps, else NULL */
+    long span_pos;            /* Carrier byte of the image the block last read starts at */
+    long span_from;           /* File offsets of the block last read */
+    long span_to;
+
+    /* Order of the data's blocks in the image, order NULL while positions are the image's own */
+    ScatterMap scatter;
+
+    /* Source image mapped read-only when it is a regular file */
+    const unsigned char *map; /* NULL when reading through stdio */
+    long map_size;
+    long offset;              /* File offset of the next byte to read */
+    long released;            /* Map pages below this offset are dropped from RSS */
+    int owns_map;             /* 0 when map is a caller's buffer */
+
+    /* Headers of a stream source, already read off it; NULL when the source can seek */
+    unsigned char *head;
+
+    /* In-memory stego image, same layout as map; NULL when writing to fptr_dest */
+    unsigned char *out;
+
+    /* Source image patched in place with pwrite, -1 when writing another image */
+    int fd_patch;
+    long patch_bytes;         /* Bytes written in place, and the pwrite calls they took */
+    long patch_writes;
+
+    /* CRC32C of the payload passing through embed/extract while tracking */
+    int track_crc;
+    uint32_t crc;
+
+    /* Reed-Solomon stripe the payload is coded through (see fec.h), NULL when it is not */
+    unsigned char *fec;
+    long fec_fill;            /* Embedding: data bytes gathered into the stripe */
+    long fec_left;            /* Extracting: corrected data bytes not handed out yet */
+    long fec_corrected;       /* Bytes the code put right so far */
+    int fec_lost;             /* A codeword had more errors than the code corrects */
+} LsbEngine;
+
+/* Attach the engine to the carrier streams of an image laid out as layout and allocate its block */
+Status lsb_engine_init(LsbEngine *engine, FILE *fptr_src, FILE *fptr_dest, const BmpLayout *layout);
+
+/* Attach the engine to a cover buffer and an output buffer of the same size (out NULL to decode) */
+Status lsb_engine_init_mem(LsbEngine *engine, const unsigned char *src, long size, unsigned char *out,
+                           const BmpLayout *layout);
+
+/* Write changed carrier bytes back into the source image, which must be mapped and open for
+ * writing, instead of to fptr_dest; bytes whose LSBs already match are not written */
+Status lsb_engine_patch_source(LsbEngine *engine);
+
+/* The source is a stream (a pipe) whose headers bmp_read_stream() read into head: copy those
+ * instead of seeking back, and only ever move forward, reading past what is skipped.
+ * The engine frees head */
+void lsb_engine_set_head(LsbEngine *engine, unsigned char *head);
+
+/* Scatter the data from the current position on in blocks ordered by key; the source must be
+ * mapped. A destination is filled with the rest of the source first, then patched like in place */
+Status lsb_engine_scatter(LsbEngine *engine, const unsigned char key[AEAD_KEY_SIZE]);
+
+/* Read the carrier through another layout from now on (decoding older images) */
+Status lsb_engine_set_layout(LsbEngine *engine, const BmpLayout *layout);
+
+/* Pack the following embed/extract calls at bits (1, 2 or 4) per carrier byte */
+Status lsb_engine_set_bits(LsbEngine *engine, int bits);
+
+/* Start (1) or stop (0) coding the data of embed/extract calls in Reed-Solomon stripes; stopping
+ * while embedding pads the last stripe with zeros and embeds it */
+Status lsb_engine_set_fec(LsbEngine *engine, int on);
+
+/* Carrier bytes size more payload bytes take from the current position, stripes rounded up */
+long lsb_engine_carrier_for(LsbEngine *engine, long size);
+
+/* Start (1, from a zero CRC) or stop (0) checksumming the data of embed/extract calls */
+void lsb_engine_track_crc(LsbEngine *engine, int on);
+
+/* Append the CRC of size payload bytes that were handled outside the engine */
+void lsb_engine_add_crc(LsbEngine *engine, uint32_t crc, long size);
+
+/* Move the read position to carrier byte pos (on a stream, never back) */
+Status lsb_engine_seek(LsbEngine *engine, long pos);
+
+/* Copy the BMP headers (everything before the pixel array) unchanged, then stand at carrier byte 0;
+ * in place there is nothing to copy */
+Status lsb_engine_copy_header(LsbEngine *engine);
+
+/* Embed size bytes of data into the next size * 8 / bits carrier bytes (a stripe at a time while coding) */
+Status lsb_engine_embed(LsbEngine *engine, const char *data, long size);
+
+/* Embed a 32-bit integer (MSB first) into the next 32 carrier bytes */
+Status lsb_engine_embed_int(LsbEngine *engine, int value);
+
+/* Extract size bytes of data from the next size * 8 / bits carrier bytes (a stripe at a time while coding) */
+Status lsb_engine_extract(LsbEngine *engine, char *data, long size);
+
+/* Extract a 32-bit integer (MSB first) from the next 32 carrier bytes */
+Status lsb_engine_extract_int(LsbEngine *engine, int *value);
+
+/* Current carrier read position */
+long lsb_engine_tell(LsbEngine *engine);
+
+/* Carrier bytes [pos, pos + size) were handled positionally: move past them */
+Status lsb_engine_skip(LsbEngine *engine, long size);
+
+/* Copy the untouched tail: copy_file_range, then sendfile, then buffered (nothing in place) */
+Status lsb_engine_copy_rest(LsbEngine *engine);
+
+/* Release the staging block and the mapping */
+void lsb_engine_free(LsbEngine *engine);
+
+/*
+ * Positional variants for worker threads
+ * They share no stream state: every call names its own carrier position
+ * and brings its own LSB_CARRIER_BLOCK staging block, plus a span buffer
+ * of BMP_SPAN_SIZE(LSB_CARRIER_BLOCK) bytes when the layout has gaps
+ */
+
+/* pread/pwrite that retry until size bytes are moved */
+Status lsb_pread_full(int fd, void *buf, long size, long offset);
+Status lsb_pwrite_full(int fd, const void *buf, long size, long offset);
+
+/* Embed data at bits per byte from carrier byte pos of the mapped source and pwrite the spans
+ * to the same offsets of fd_dest; *crc (if not NULL) is continued over data */
+Status lsb_embed_at(const unsigned char *map, const BmpLayout *layout, int fd_dest, long pos,
+                    const char *data, long size, int bits, char *block, unsigned char *span, uint32_t *crc);
+
+/* pread the carrier from byte pos of fd_src and extract size bytes packed at bits per byte;
+ * *crc (if not NULL) is continued over the extracted data */
+Status lsb_extract_at(int fd_src, const BmpLayout *layout, long pos, char *data, long size, int bits,
+                      char *block, unsigned char *span, uint32_t *crc);
+
+#endif
@@ -0,0 +1,506 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - SIMD bit pack/unpack kernels
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "lsb_kernels.h"
+#include "encode.h"
+#include "decode.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LSB_X86 1
+#endif
+
+// Scalar fallback: the original per-bit loops, 8 carrier bytes at a time
+static void embed_scalar(unsigned char *dest, const unsigned char *carrier,
+                         const unsigned char *data, long size)
+{
+    long i;
+
+    if (dest != carrier)
+        memcpy(dest, carrier, size * 8);
+    for (i = 0; i < size; i++)
+    {
+        encode_byte_to_lsb(data[i], (char *)dest + i * 8);
+    }
+}
+
+static void extract_scalar(unsigned char *data, const unsigned char *carrier, long size)
+{
+    long i;
+
+    for (i = 0; i < size; i++)
+    {
+        decode_byte_from_lsb((char *)&data[i], (char *)carrier + i * 8);
+    }
+}
+
+// Scalar k-bit packing; bits is a constant at every call site, so each
+// density gets its own unrolled copy instead of a loop over a runtime count
+static inline __attribute__((always_inline)) void embed_scalar_bits(unsigned char *dest, const unsigned char *carrier,
+                                                                    const unsigned char *data, long size, const int bits)
+{
+    const int per_byte = 8 / bits;
+    const unsigned char mask = (1 << bits) - 1;
+    long i;
+    int j;
+
+    for (i = 0; i < size; i++)
+    {
+        for (j = 0; j < per_byte; j++)
+        {
+            dest[i * per_byte + j] = (carrier[i * per_byte + j] & ~mask) |
+                                     ((data[i] >> (8 - bits * (j + 1))) & mask);
+        }
+    }
+}
+
+static inline __attribute__((always_inline)) void extract_scalar_bits(unsigned char *data, const unsigned char *carrier,
+                                                                      long size, const int bits)
+{
+    const int per_byte = 8 / bits;
+    const unsigned char mask = (1 << bits) - 1;
+    unsigned char value;
+    long i;
+    int j;
+
+    for (i = 0; i < size; i++)
+    {
+        value = 0;
+        for (j = 0; j < per_byte; j++)
+        {
+            value = (value << bits) | (carrier[i * per_byte + j] & mask);
+        }
+        data[i] = value;
+    }
+}
+
+static void embed_scalar2(unsigned char *dest, const unsigned char *carrier, const unsigned char *data, long size)
+{
+    embed_scalar_bits(dest, carrier, data, size, 2);
+}
+
+static void extract_scalar2(unsigned char *data, const unsigned char *carrier, long size)
+{
+    extract_scalar_bits(data, carrier, size, 2);
+}
+
+static void embed_scalar4(unsigned char *dest, const unsigned char *carrier, const unsigned char *data, long size)
+{
+    embed_scalar_bits(dest, carrier, data, size, 4);
+}
+
+static void extract_scalar4(unsigned char *data, const unsigned char *carrier, long size)
+{
+    extract_scalar_bits(data, carrier, size, 4);
+}
+
+#ifdef LSB_X86
+
+// Bit-reversal of a byte, used to turn movemask order into MSB-first order
+static const unsigned char bit_reverse[256] = {
+#define R2(n) n, n + 2 * 64, n + 1 * 64, n + 3 * 64
+#define R4(n) R2(n), R2(n + 2 * 16), R2(n + 1 * 16), R2(n + 3 * 16)
+#define R6(n) R4(n), R4(n + 2 * 4), R4(n + 1 * 4), R4(n + 3 * 4)
+    R6(0), R6(2), R6(1), R6(3)
+#undef R2
+#undef R4
+#undef R6
+};
+
+// SSE2: 2 payload bytes are broadcast over 16 carrier bytes per step
+__attribute__((target("sse2"))) static void embed_sse2(unsigned char *dest, const unsigned char *carrier,
+                                                       const unsigned char *data, long size)
+{
+    const __m128i bitsel = _mm_setr_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                         (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i v, c;
+    long i;
+
+    for (i = 0; i + 2 <= size; i += 2)
+    {
+        v = _mm_cvtsi32_si128(data[i] | (data[i + 1] << 8));
+        v = _mm_unpacklo_epi8(v, v);  // b0 b0 b1 b1
+        v = _mm_unpacklo_epi16(v, v); // b0 x4, b1 x4
+        v = _mm_unpacklo_epi32(v, v); // b0 x8, b1 x8
+        v = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(v, bitsel), bitsel), one);
+
+        c = _mm_loadu_si128((const __m128i *)(carrier + i * 8));
+        c = _mm_or_si128(_mm_andnot_si128(one, c), v);
+        _mm_storeu_si128((__m128i *)(dest + i * 8), c);
+    }
+    embed_scalar(dest + i * 8, carrier + i * 8, data + i, size - i);
+}
+
+__attribute__((target("sse2"))) static void extract_sse2(unsigned char *data, const unsigned char *carrier, long size)
+{
+    __m128i c;
+    int mask;
+    long i;
+
+    for (i = 0; i + 2 <= size; i += 2)
+    {
+        // Move every LSB into the sign bit and collect the 16 of them
+        c = _mm_loadu_si128((const __m128i *)(carrier + i * 8));
+        mask = _mm_movemask_epi8(_mm_slli_epi16(c, 7));
+        data[i] = bit_reverse[mask & 0xFF];
+        data[i + 1] = bit_reverse[mask >> 8];
+    }
+    extract_scalar(data + i, carrier + i * 8, size - i);
+}
+
+// BMI2: PDEP/PEXT move one payload byte to/from 8 carrier bytes at once
+#define LSB_QWORD_MASK 0x0101010101010101ULL
+
+__attribute__((target("bmi2"))) static void embed_bmi2(unsigned char *dest, const unsigned char *carrier,
+                                                       const unsigned char *data, long size)
+{
+    uint64_t c;
+    long i;
+
+    for (i = 0; i < size; i++)
+    {
+        memcpy(&c, carrier + i * 8, 8);
+        c = (c & ~LSB_QWORD_MASK) | __builtin_bswap64(_pdep_u64(data[i], LSB_QWORD_MASK));
+        memcpy(dest + i * 8, &c, 8);
+    }
+}
+
+__attribute__((target("bmi2"))) static void extract_bmi2(unsigned char *data, const unsigned char *carrier, long size)
+{
+    uint64_t c;
+    long i;
+
+    for (i = 0; i < size; i++)
+    {
+        memcpy(&c, carrier + i * 8, 8);
+        data[i] = (unsigned char)_pext_u64(__builtin_bswap64(c), LSB_QWORD_MASK);
+    }
+}
+
+// AVX2: 4 payload bytes are shuffled over 32 carrier bytes per step
+__attribute__((target("avx2"))) static void embed_avx2(unsigned char *dest, const unsigned char *carrier,
+                                                       const unsigned char *data, long size)
+{
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i bitsel = _mm256_set1_epi64x(0x0102040810204080LL);
+    const __m256i one = _mm256_set1_epi8(1);
+    __m256i v, c;
+    int32_t word;
+    long i;
+
+    for (i = 0; i + 4 <= size; i += 4)
+    {
+        memcpy(&word, data + i, 4);
+        v = _mm256_shuffle_epi8(_mm256_set1_epi32(word), spread);
+        v = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v, bitsel), bitsel), one);
+
+        c = _mm256_loadu_si256((const __m256i *)(carrier + i * 8));
+        c = _mm256_or_si256(_mm256_andnot_si256(one, c), v);
+        _mm256_storeu_si256((__m256i *)(dest + i * 8), c);
+    }
+    embed_scalar(dest + i * 8, carrier + i * 8, data + i, size - i);
+}
+
+__attribute__((target("avx2"))) static void extract_avx2(unsigned char *data, const unsigned char *carrier, long size)
+{
+    // Reverse every 8-byte group so movemask yields MSB-first bytes directly
+    const __m256i reverse = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    __m256i c;
+    int32_t word;
+    long i;
+
+    for (i = 0; i + 4 <= size; i += 4)
+    {
+        c = _mm256_loadu_si256((const __m256i *)(carrier + i * 8));
+        c = _mm256_shuffle_epi8(c, reverse);
+        word = _mm256_movemask_epi8(_mm256_slli_epi16(c, 7));
+        memcpy(data + i, &word, 4);
+    }
+    extract_scalar(data + i, carrier + i * 8, size - i);
+}
+
+// SSE2, 2 bits: 16 payload bytes are split into four 2-bit planes and
+// interleaved back over 64 carrier bytes
+__attribute__((target("sse2"))) static void embed_sse2_2(unsigned char *dest, const unsigned char *carrier,
+                                                         const unsigned char *data, long size)
+{
+    const __m128i low2 = _mm_set1_epi8(0x03);
+    __m128i v, a, b, c, d, ab, cd, out[4];
+    long i;
+    int j;
+
+    for (i = 0; i + 16 <= size; i += 16)
+    {
+        v = _mm_loadu_si128((const __m128i *)(data + i));
+        a = _mm_and_si128(_mm_srli_epi16(v, 6), low2);
+        b = _mm_and_si128(_mm_srli_epi16(v, 4), low2);
+        c = _mm_and_si128(_mm_srli_epi16(v, 2), low2);
+        d = _mm_and_si128(v, low2);
+
+        ab = _mm_unpacklo_epi8(a, b);
+        cd = _mm_unpacklo_epi8(c, d);
+        out[0] = _mm_unpacklo_epi16(ab, cd);
+        out[1] = _mm_unpackhi_epi16(ab, cd);
+        ab = _mm_unpackhi_epi8(a, b);
+        cd = _mm_unpackhi_epi8(c, d);
+        out[2] = _mm_unpacklo_epi16(ab, cd);
+        out[3] = _mm_unpackhi_epi16(ab, cd);
+
+        for (j = 0; j < 4; j++)
+        {
+            c = _mm_loadu_si128((const __m128i *)(carrier + i * 4 + j * 16));
+            c = _mm_or_si128(_mm_andnot_si128(low2, c), out[j]);
+            _mm_storeu_si128((__m128i *)(dest + i * 4 + j * 16), c);
+        }
+    }
+    embed_scalar2(dest + i * 4, carrier + i * 4, data + i, size - i);
+}
+
+__attribute__((target("sse2"))) static void extract_sse2_2(unsigned char *data, const unsigned char *carrier, long size)
+{
+    const __m128i low2 = _mm_set1_epi8(0x03);
+    const __m128i low4_16 = _mm_set1_epi16(0x000F);
+    const __m128i low8_32 = _mm_set1_epi32(0x000000FF);
+    __m128i c, z[4];
+    long i;
+    int j;
+
+    for (i = 0; i + 16 <= size; i += 16)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            // Fold 4 carrier bytes into one payload byte in two steps: pairs, then quads
+            c = _mm_and_si128(_mm_loadu_si128((const __m128i *)(carrier + i * 4 + j * 16)), low2);
+            c = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(c, 2), _mm_srli_epi16(c, 8)), low4_16);
+            z[j] = _mm_and_si128(_mm_or_si128(_mm_slli_epi32(c, 4), _mm_srli_epi32(c, 16)), low8_32);
+        }
+        c = _mm_packus_epi16(_mm_packs_epi32(z[0], z[1]), _mm_packs_epi32(z[2], z[3]));
+        _mm_storeu_si128((__m128i *)(data + i), c);
+    }
+    extract_scalar2(data + i, carrier + i * 4, size - i);
+}
+
+// SSE2, 4 bits: high and low nibbles of 16 payload bytes interleave over 32 carrier bytes
+__attribute__((target("sse2"))) static void embed_sse2_4(unsigned char *dest, const unsigned char *carrier,
+                                                         const unsigned char *data, long size)
+{
+    const __m128i low4 = _mm_set1_epi8(0x0F);
+    __m128i v, hi, lo, c;
+    long i;
+
+    for (i = 0; i + 16 <= size; i += 16)
+    {
+        v = _mm_loadu_si128((const __m128i *)(data + i));
+        hi = _mm_and_si128(_mm_srli_epi16(v, 4), low4);
+        lo = _mm_and_si128(v, low4);
+
+        c = _mm_loadu_si128((const __m128i *)(carrier + i * 2));
+        c = _mm_or_si128(_mm_andnot_si128(low4, c), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(dest + i * 2), c);
+
+        c = _mm_loadu_si128((const __m128i *)(carrier + i * 2 + 16));
+        c = _mm_or_si128(_mm_andnot_si128(low4, c), _mm_unpackhi_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(dest + i * 2 + 16), c);
+    }
+    embed_scalar4(dest + i * 2, carrier + i * 2, data + i, size - i);
+}
+
+__attribute__((target("sse2"))) static void extract_sse2_4(unsigned char *data, const unsigned char *carrier, long size)
+{
+    const __m128i low4 = _mm_set1_epi8(0x0F);
+    const __m128i low8_16 = _mm_set1_epi16(0x00FF);
+    __m128i c0, c1;
+    long i;
+
+    for (i = 0; i + 16 <= size; i += 16)
+    {
+        // Each 16-bit lane holds one payload byte: high nibble below, low nibble above
+        c0 = _mm_and_si128(_mm_loadu_si128((const __m128i *)(carrier + i * 2)), low4);
+        c1 = _mm_and_si128(_mm_loadu_si128((const __m128i *)(carrier + i * 2 + 16)), low4);
+        c0 = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(c0, 4), _mm_srli_epi16(c0, 8)), low8_16);
+        c1 = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(c1, 4), _mm_srli_epi16(c1, 8)), low8_16);
+        _mm_storeu_si128((__m128i *)(data + i), _mm_packus_epi16(c0, c1));
+    }
+    extract_scalar4(data + i, carrier + i * 2, size - i);
+}
+
+// BMI2, 2 and 4 bits: one PDEP/PEXT per 8 carrier bytes, as for 1 bit
+#define LSB_QWORD_MASK2 0x0303030303030303ULL
+#define LSB_QWORD_MASK4 0x0F0F0F0F0F0F0F0FULL
+
+__attribute__((target("bmi2"))) static void embed_bmi2_2(unsigned char *dest, const unsigned char *carrier,
+                                                         const unsigned char *data, long size)
+{
+    uint64_t c;
+    long i;
+
+    for (i = 0; i + 2 <= size; i += 2)
+    {
+        memcpy(&c, carrier + i * 4, 8);
+        c = (c & ~LSB_QWORD_MASK2) |
+            __builtin_bswap64(_pdep_u64((data[i] << 8) | data[i + 1], LSB_QWORD_MASK2));
+        memcpy(dest + i * 4, &c, 8);
+    }
+    embed_scalar2(dest + i * 4, carrier + i * 4, data + i, size - i);
+}
+
+__attribute__((target("bmi2"))) static void extract_bmi2_2(unsigned char *data, const unsigned char *carrier, long size)
+{
+    uint64_t c, v;
+    long i;
+
+    for (i = 0; i + 2 <= size; i += 2)
+    {
+        memcpy(&c, carrier + i * 4, 8);
+        v = _pext_u64(__builtin_bswap64(c), LSB_QWORD_MASK2);
+        data[i] = v >> 8;
+        data[i + 1] = v;
+    }
+    extract_scalar2(data + i, carrier + i * 4, size - i);
+}
+
+__attribute__((target("bmi2"))) static void embed_bmi2_4(unsigned char *dest, const unsigned char *carrier,
+                                                         const unsigned char *data, long size)
+{
+    uint64_t c;
+    uint32_t word;
+    long i;
+
+    for (i = 0; i + 4 <= size; i += 4)
+    {
+        memcpy(&word, data + i, 4);
+        memcpy(&c, carrier + i * 2, 8);
+        c = (c & ~LSB_QWORD_MASK4) | __builtin_bswap64(_pdep_u64(__builtin_bswap32(word), LSB_QWORD_MASK4));
+        memcpy(dest + i * 2, &c, 8);
+    }
+    embed_scalar4(dest + i * 2, carrier + i * 2, data + i, size - i);
+}
+
+__attribute__((target("bmi2"))) static void extract_bmi2_4(unsigned char *data, const unsigned char *carrier, long size)
+{
+    uint64_t c;
+    uint32_t word;
+    long i;
+
+    for (i = 0; i + 4 <= size; i += 4)
+    {
+        memcpy(&c, carrier + i * 2, 8);
+        word = __builtin_bswap32((uint32_t)_pext_u64(__builtin_bswap64(c), LSB_QWORD_MASK4));
+        memcpy(data + i, &word, 4);
+    }
+    extract_scalar4(data + i, carrier + i * 2, size - i);
+}
+
+#endif
+
+// In order of preference for each density
+static const LsbKernel kernels[] = {
+#ifdef LSB_X86
+    {"avx2", 1, embed_avx2, extract_avx2},
+    {"bmi2", 1, embed_bmi2, extract_bmi2},
+    {"sse2", 1, embed_sse2, extract_sse2},
+    {"bmi2", 2, embed_bmi2_2, extract_bmi2_2},
+    {"sse2", 2, embed_sse2_2, extract_sse2_2},
+    {"sse2", 4, embed_sse2_4, extract_sse2_4},
+    {"bmi2", 4, embed_bmi2_4, extract_bmi2_4},
+#endif
+    {"scalar", 1, embed_scalar, extract_scalar},
+    {"scalar", 2, embed_scalar2, extract_scalar2},
+    {"scalar", 4, embed_scalar4, extract_scalar4},
+};
+
+#define LSB_KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+// Selected kernel per density, indexed by log2(bits)
+static const LsbKernel *selected[3];
+
+// Check CPUID for the instruction set a kernel needs
+static int kernel_supported(const LsbKernel *kernel)
+{
+#ifdef LSB_X86
+    __builtin_cpu_init();
+    if (strcmp(kernel->name, "avx2") == 0)
+        return __builtin_cpu_supports("avx2");
+    if (strcmp(kernel->name, "bmi2") == 0)
+        return __builtin_cpu_supports("bmi2");
+    if (strcmp(kernel->name, "sse2") == 0)
+        return __builtin_cpu_supports("sse2");
+#endif
+    return strcmp(kernel->name, "scalar") == 0;
+}
+
+// log2 of a supported density, -1 otherwise
+static int density_index(int bits)
+{
+    switch (bits)
+    {
+    case 1:
+        return 0;
+    case 2:
+        return 1;
+    case 4:
+        return 2;
+    }
+    return -1;
+}
+
+// Look up a kernel by name and density, only if this CPU can run it
+const LsbKernel *lsb_kernel_by_name(const char *name, int bits)
+{
+    unsigned i;
+
+    for (i = 0; i < LSB_KERNEL_COUNT; i++)
+    {
+        if (kernels[i].bits == bits && strcmp(kernels[i].name, name) == 0)
+            return kernel_supported(&kernels[i]) ? &kernels[i] : NULL;
+    }
+    return NULL;
+}
+
+// Runs once at startup: honour STEGO_KERNEL, else take the first supported kernel
+// (a density without the requested variant also falls back to the first supported)
+__attribute__((constructor)) static void lsb_kernels_select(void)
+{
+    const char *name = getenv("STEGO_KERNEL");
+    static const int densities[] = {1, 2, 4};
+    const LsbKernel *kernel;
+    unsigned i, d;
+
+    for (d = 0; d < 3; d++)
+    {
+        if (name != NULL && (kernel = lsb_kernel_by_name(name, densities[d])) != NULL)
+        {
+            selected[d] = kernel;
+            continue;
+        }
+
+        for (i = 0; i < LSB_KERNEL_COUNT; i++)
+        {
+            if (kernels[i].bits == densities[d] && kernel_supported(&kernels[i]))
+            {
+                selected[d] = &kernels[i];
+                break;
+            }
+        }
+    }
+}
+
+const LsbKernel *lsb_kernel(void)
+{
+    return selected[0];
+}
+
+const LsbKernel *lsb_kernel_bits(int bits)
+{
+    int index = density_index(bits);
+
+    return index < 0 ? NULL : selected[index];
+}
@@ -0,0 +1,39 @@
+#ifndef LSB_KERNELS_H
+#define LSB_KERNELS_H
+
+/*
+ * Bit pack/unpack kernels
+ * embed spreads every payload byte (MSB first) over the low bits of
+ * 8 / bits carrier bytes, extract gathers them back. dest may alias
+ * carrier. Each density (1, 2 or 4 bits per carrier byte) has its own
+ * kernels; the fastest one the CPU supports is chosen once at startup
+ * and STEGO_KERNEL=scalar|sse2|bmi2|avx2 overrides the choice.
+ */
+
+#define LSB_MAX_BITS 4
+
+typedef void (*lsb_embed_fn)(unsigned char *dest, const unsigned char *carrier,
+                             const unsigned char *data, long size);
+typedef void (*lsb_extract_fn)(unsigned char *data, const unsigned char *carrier, long size);
+
+typedef struct
+{
+    const char *name;
+    int bits;               /* Payload bits per carrier byte */
+    lsb_embed_fn embed;     /* size payload bytes -> size * 8 / bits carrier bytes */
+    lsb_extract_fn extract; /* size * 8 / bits carrier bytes -> size payload bytes */
+} LsbKernel;
+
+/* Carrier bytes holding size payload bytes at a density */
+#define LSB_CARRIER_SIZE(size, bits) ((size) * 8 / (bits))
+
+/* 1-bit kernel selected for this CPU (header fields always use it) */
+const LsbKernel *lsb_kernel(void);
+
+/* Kernel selected for a density of 1, 2 or 4 bits, NULL for any other */
+const LsbKernel *lsb_kernel_bits(int bits);
+
+/* Kernel by name and density, NULL when unknown or not supported by this CPU */
+const LsbKernel *lsb_kernel_by_name(const char *name, int bits);
+
+#endif
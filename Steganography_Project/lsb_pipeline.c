@@ -0,0 +1,267 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - three-stage data pipeline
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "lsb_pipeline.h"
+#include "spsc.h"
+#include "crc32c.h"
+#include "bmp.h"
+
+// One payload block and its carrier on the way round
+typedef struct
+{
+    long pos;                  /* First carrier byte */
+    long size;                 /* Payload bytes */
+    long from, to;             /* File span of the carrier */
+    const unsigned char *span; /* The span as read: in the mapping or in buf */
+    unsigned char *buf;        /* Span read through stdio, then the modified span to write */
+    unsigned char *carrier;    /* Gathered carrier when the layout has gaps */
+    char *data;                /* Payload */
+} PipeBlock;
+
+typedef struct
+{
+    LsbEngine *engine;
+    FILE *fptr_data;
+    long size;
+    long count;                /* Blocks the payload takes */
+    int embed;
+    SpscRing free_ring;        /* Writer -> reader: blocks to refill */
+    SpscRing read_ring;        /* Reader -> worker */
+    SpscRing done_ring;        /* Worker -> writer */
+    _Atomic int failed;        /* Set by any stage: the others pass blocks on untouched */
+    PipeBlock blocks[PIPELINE_DEPTH];
+} Pipeline;
+
+// Touch one byte per page of a mapped span
+static void prefault(const unsigned char *span, long length)
+{
+    long page = sysconf(_SC_PAGESIZE), i;
+    volatile unsigned char sink = 0;
+
+    for (i = 0; i < length; i += page)
+        sink += span[i];
+    sink += span[length - 1];
+}
+
+// Reader: the payload block (embedding) and the span of carrier it goes into
+static void *read_stage(void *arg)
+{
+    Pipeline *pipeline = arg;
+    LsbEngine *engine = pipeline->engine;
+    long i, pos = engine->pos, done = 0, length;
+    PipeBlock *block;
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        block = spsc_pop(&pipeline->free_ring);
+        block->pos = pos;
+        block->size = pipeline->size - done < LSB_PAYLOAD_BLOCK ? pipeline->size - done : LSB_PAYLOAD_BLOCK;
+        block->from = bmp_offset(&engine->layout, pos);
+        block->to = bmp_offset(&engine->layout, pos + LSB_CARRIER_SIZE(block->size, engine->kernel->bits));
+        length = block->to - block->from;
+        pos += LSB_CARRIER_SIZE(block->size, engine->kernel->bits);
+        done += block->size;
+
+        if (!atomic_load(&pipeline->failed))
+        {
+            if (pipeline->embed && fread(block->data, 1, block->size, pipeline->fptr_data) != (size_t)block->size)
+                atomic_store(&pipeline->failed, 1);
+            if (engine->map != NULL)
+            {
+                // Fault the span in here, so a slow volume is waited on by this stage, not the worker
+                block->span = engine->map + block->from;
+                if (block->to > engine->map_size)
+                    atomic_store(&pipeline->failed, 1);
+                else
+                    prefault(block->span, length);
+            }
+            else
+            {
+                // Sequential stdio: the file position is already at block->from
+                block->span = block->buf;
+                if (fread(block->buf, 1, length, engine->fptr_src) != (size_t)length)
+                    atomic_store(&pipeline->failed, 1);
+            }
+        }
+        spsc_push(&pipeline->read_ring, block);
+    }
+    return NULL;
+}
+
+// Worker: LSBs in or out, the checksum, and the mapping pages this block was the last to use
+static void *work_stage(void *arg)
+{
+    Pipeline *pipeline = arg;
+    LsbEngine *engine = pipeline->engine;
+    const LsbKernel *kernel = engine->kernel;
+    long page = sysconf(_SC_PAGESIZE);
+    long i, bytes, from, to;
+    const unsigned char *carrier;
+    PipeBlock *block;
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        block = spsc_pop(&pipeline->read_ring);
+        if (!atomic_load(&pipeline->failed))
+        {
+            bytes = LSB_CARRIER_SIZE(block->size, kernel->bits);
+            carrier = block->span;
+            if (!engine->layout.packed)
+            {
+                bmp_gather(&engine->layout, block->pos, bytes, block->span, block->carrier);
+                carrier = block->carrier;
+            }
+
+            if (!pipeline->embed)
+            {
+                kernel->extract((unsigned char *)block->data, carrier, block->size);
+            }
+            else if (engine->layout.packed)
+            {
+                kernel->embed(block->buf, carrier, (const unsigned char *)block->data, block->size);
+            }
+            else
+            {
+                // Padding and fourth pixel bytes go out as they came in
+                kernel->embed(block->carrier, carrier, (const unsigned char *)block->data, block->size);
+                if (block->span != block->buf)
+                    memcpy(block->buf, block->span, block->to - block->from);
+                bmp_scatter(&engine->layout, block->pos, bytes, block->carrier, block->buf);
+            }
+            if (engine->track_crc)
+                engine->crc = crc32c_update(engine->crc, block->data, block->size);
+
+            from = (block->from + page - 1) & ~(page - 1);
+            to = block->to & ~(page - 1);
+            if (engine->map != NULL && engine->owns_map && to > from)
+                madvise((void *)(engine->map + from), to - from, MADV_DONTNEED);
+        }
+        spsc_push(&pipeline->done_ring, block);
+    }
+    return NULL;
+}
+
+// Writer, on the calling thread: the modified span or the extracted payload
+static void write_stage(Pipeline *pipeline)
+{
+    FILE *fptr = pipeline->embed ? pipeline->engine->fptr_dest : pipeline->fptr_data;
+    const void *out;
+    long i, length;
+    PipeBlock *block;
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        block = spsc_pop(&pipeline->done_ring);
+        if (!atomic_load(&pipeline->failed))
+        {
+            out = pipeline->embed ? (const void *)block->buf : (const void *)block->data;
+            length = pipeline->embed ? block->to - block->from : block->size;
+            if (fwrite(out, 1, length, fptr) != (size_t)length)
+                atomic_store(&pipeline->failed, 1);
+        }
+        spsc_push(&pipeline->free_ring, block);
+    }
+}
+
+static void free_pipeline(Pipeline *pipeline)
+{
+    int i;
+
+    for (i = 0; i < PIPELINE_DEPTH; i++)
+    {
+        free(pipeline->blocks[i].buf);
+        free(pipeline->blocks[i].carrier);
+        free(pipeline->blocks[i].data);
+    }
+    spsc_free(&pipeline->free_ring);
+    spsc_free(&pipeline->read_ring);
+    spsc_free(&pipeline->done_ring);
+}
+
+// Every stage handles every block, failed or not, so none waits on a block that never comes
+static Status run_pipeline(LsbEngine *engine, FILE *fptr_data, long size, int embed)
+{
+    Pipeline pipeline;
+    pthread_t reader, worker;
+    Status ret = e_failure;
+    int i, ok = 1;
+
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.engine = engine;
+    pipeline.fptr_data = fptr_data;
+    pipeline.size = size;
+    pipeline.count = (size + LSB_PAYLOAD_BLOCK - 1) / LSB_PAYLOAD_BLOCK;
+    pipeline.embed = embed;
+    atomic_init(&pipeline.failed, 0);
+
+    if (spsc_init(&pipeline.free_ring, PIPELINE_DEPTH) == e_failure ||
+        spsc_init(&pipeline.read_ring, PIPELINE_DEPTH) == e_failure ||
+        spsc_init(&pipeline.done_ring, PIPELINE_DEPTH) == e_failure)
+        ok = 0;
+    for (i = 0; ok && i < PIPELINE_DEPTH; i++)
+    {
+        pipeline.blocks[i].buf = malloc(BMP_SPAN_SIZE(LSB_CARRIER_BLOCK));
+        pipeline.blocks[i].carrier = engine->layout.packed ? NULL : malloc(LSB_CARRIER_BLOCK);
+        pipeline.blocks[i].data = malloc(LSB_PAYLOAD_BLOCK);
+        if (pipeline.blocks[i].buf == NULL || pipeline.blocks[i].data == NULL ||
+            (!engine->layout.packed && pipeline.blocks[i].carrier == NULL))
+            ok = 0;
+        else
+            spsc_push(&pipeline.free_ring, &pipeline.blocks[i]);
+    }
+    if (!ok)
+    {
+        free_pipeline(&pipeline);
+        return e_failure;
+    }
+
+    if (pthread_create(&reader, NULL, read_stage, &pipeline) != 0)
+    {
+        free_pipeline(&pipeline);
+        return e_failure;
+    }
+    if (pthread_create(&worker, NULL, work_stage, &pipeline) != 0)
+    {
+        // Without a worker the reader still has to be drained
+        atomic_store(&pipeline.failed, 1);
+        for (i = 0; i < pipeline.count; i++)
+            spsc_push(&pipeline.free_ring, spsc_pop(&pipeline.read_ring));
+        pthread_join(reader, NULL);
+        free_pipeline(&pipeline);
+        return e_failure;
+    }
+
+    write_stage(&pipeline);
+    pthread_join(reader, NULL);
+    pthread_join(worker, NULL);
+
+    // The engine stands past the data, as if it had embedded or extracted it itself
+    if (!atomic_load(&pipeline.failed))
+    {
+        engine->pos += LSB_CARRIER_SIZE(size, engine->kernel->bits);
+        engine->offset = bmp_offset(&engine->layout, engine->pos);
+        ret = e_success;
+    }
+    free_pipeline(&pipeline);
+    return ret;
+}
+
+Status lsb_pipeline_embed(LsbEngine *engine, FILE *fptr_data, long size)
+{
+    if (engine->fptr_dest == NULL || engine->out != NULL || engine->fd_patch >= 0)
+        return e_failure;
+    return run_pipeline(engine, fptr_data, size, 1);
+}
+
+Status lsb_pipeline_extract(LsbEngine *engine, FILE *fptr_data, long size)
+{
+    return run_pipeline(engine, fptr_data, size, 0);
+}
@@ -0,0 +1,26 @@
+#ifndef LSB_PIPELINE_H
+#define LSB_PIPELINE_H
+
+#include <stdio.h>
+#include "types.h" // Contains user defined types
+#include "lsb_engine.h"
+
+/*
+ * Three-stage data pipeline
+ * A reader thread fetches payload and carrier spans, a worker thread
+ * embeds or extracts them and the calling thread writes the results, so
+ * reads, LSB work and writes overlap instead of adding up. The stages
+ * hand PIPELINE_DEPTH blocks of one payload block each around a cycle
+ * of single-producer/single-consumer rings (see spsc.h).
+ */
+
+#define PIPELINE_DEPTH 4
+
+/* Embed size bytes read from fptr_data at engine's carrier position, writing spans to its fptr_dest
+ * (not in place, not into a buffer) */
+Status lsb_pipeline_embed(LsbEngine *engine, FILE *fptr_data, long size);
+
+/* Extract size bytes from engine's carrier position and write them to fptr_data */
+Status lsb_pipeline_extract(LsbEngine *engine, FILE *fptr_data, long size);
+
+#endif
@@ -0,0 +1,215 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - block LZ compression
+*/
+#include <string.h>
+#include <stdint.h>
+#include "lz.h"
+
+// The last bytes of a block are always literals, no match starts this close to the end
+#define LZ_LAST_LITERALS 5
+#define LZ_MATCH_LIMIT 12
+
+static inline uint32_t read32(const unsigned char *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint32_t hash4(const unsigned char *p)
+{
+    return (read32(p) * 2654435761U) >> (32 - LZ_HASH_LOG);
+}
+
+// Bytes equal from a and b onwards, stopping at end (8 at a time)
+static inline long match_length(const unsigned char *a, const unsigned char *b, const unsigned char *end)
+{
+    const unsigned char *start = a;
+    uint64_t x, y;
+
+    while (a + 8 <= end)
+    {
+        memcpy(&x, a, 8);
+        memcpy(&y, b, 8);
+        if (x != y)
+            return a - start + (__builtin_ctzll(x ^ y) >> 3);
+        a += 8;
+        b += 8;
+    }
+    while (a < end && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return a - start;
+}
+
+// Length continuation bytes: 255 while more follows
+static inline unsigned char *put_length(unsigned char *op, long length)
+{
+    while (length >= 255)
+    {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (unsigned char)length;
+    return op;
+}
+
+// One sequence: literals [anchor, anchor + literals), then a match (0 length: last sequence)
+static unsigned char *put_sequence(unsigned char *op, unsigned char *oend, const unsigned char *anchor,
+                                   long literals, long offset, long match)
+{
+    unsigned char *token = op++;
+
+    // Token, literal run and the longest possible length bytes must fit
+    if (oend - op < literals + literals / 255 + match / 255 + 4)
+        return NULL;
+
+    *token = (literals >= 15 ? 15 : literals) << 4;
+    if (literals >= 15)
+        op = put_length(op, literals - 15);
+    memcpy(op, anchor, literals);
+    op += literals;
+
+    if (match == 0)
+        return op;
+
+    *op++ = offset & 0xFF;
+    *op++ = offset >> 8;
+    match -= LZ_MIN_MATCH;
+    *token |= match >= 15 ? 15 : match;
+    if (match >= 15)
+        op = put_length(op, match - 15);
+    return op;
+}
+
+long lz_compress(const unsigned char *src, long size, unsigned char *dst, long capacity)
+{
+    uint32_t table[1 << LZ_HASH_LOG];
+    const unsigned char *ip = src, *anchor = src, *ref;
+    const unsigned char *end = src + size;
+    const unsigned char *limit = end - LZ_MATCH_LIMIT;
+    unsigned char *op = dst, *oend = dst + capacity;
+    uint32_t h;
+    long match;
+
+    memset(table, 0, sizeof(table));
+    while (size > LZ_MATCH_LIMIT && ip < limit)
+    {
+        h = hash4(ip);
+        ref = src + table[h];
+        table[h] = ip - src;
+
+        if (ref >= ip || ip - ref > LZ_MAX_OFFSET || read32(ref) != read32(ip))
+        {
+            // Step faster through data that keeps missing
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+
+        match = LZ_MIN_MATCH + match_length(ip + LZ_MIN_MATCH, ref + LZ_MIN_MATCH, end - LZ_LAST_LITERALS);
+        op = put_sequence(op, oend, anchor, ip - anchor, ip - ref, match);
+        if (op == NULL)
+            return -1;
+        ip += match;
+        anchor = ip;
+    }
+
+    op = put_sequence(op, oend, anchor, end - anchor, 0, 0);
+    return op == NULL ? -1 : op - dst;
+}
+
+// Copy size bytes 8 at a time, possibly writing up to 7 bytes past dst + size
+static inline void wild_copy(unsigned char *dst, const unsigned char *src, long size)
+{
+    unsigned char *end = dst + size;
+
+    do
+    {
+        memcpy(dst, src, 8);
+        dst += 8;
+        src += 8;
+    } while (dst < end);
+}
+
+// Length continuation bytes; -1 when the input ends inside them
+static inline long get_length(const unsigned char **ip, const unsigned char *iend, long length)
+{
+    unsigned char b;
+
+    do
+    {
+        if (*ip >= iend)
+            return -1;
+        b = *(*ip)++;
+        length += b;
+    } while (b == 255);
+    return length;
+}
+
+long lz_decompress(const unsigned char *src, long size, unsigned char *dst, long capacity)
+{
+    const unsigned char *ip = src, *iend = src + size;
+    unsigned char *op = dst, *oend = dst + capacity;
+    const unsigned char *ref;
+    long literals, match, offset;
+    unsigned char token;
+
+    while (ip < iend)
+    {
+        token = *ip++;
+
+        literals = token >> 4;
+        if (literals == 15 && (literals = get_length(&ip, iend, literals)) < 0)
+            return -1;
+        if (literals > iend - ip || literals > oend - op)
+            return -1;
+        if (literals <= iend - ip - 8 && literals <= oend - op - 8)
+            wild_copy(op, ip, literals);
+        else
+            memcpy(op, ip, literals);
+        op += literals;
+        ip += literals;
+
+        // Last sequence carries literals only
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return -1;
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op - dst)
+            return -1;
+
+        match = token & 15;
+        if (match == 15 && (match = get_length(&ip, iend, match)) < 0)
+            return -1;
+        match += LZ_MIN_MATCH;
+        if (match > oend - op)
+            return -1;
+
+        // Overlapping matches repeat the last offset bytes, copy them one by one
+        ref = op - offset;
+        if (offset >= 8 && match <= oend - op - 8)
+        {
+            wild_copy(op, ref, match);
+            op += match;
+        }
+        else if (offset >= match)
+        {
+            memcpy(op, ref, match);
+            op += match;
+        }
+        else
+        {
+            while (match-- > 0)
+                *op++ = *ref++;
+        }
+    }
+    return op - dst;
+}
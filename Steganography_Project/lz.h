@@ -0,0 +1,26 @@
+#ifndef LZ_H
+#define LZ_H
+
+/*
+ * Block LZ compressor (LZ4-style sequences)
+ * Each block is compressed on its own with a 64 KiB window, so memory
+ * stays bounded by one block plus a 64 KiB hash table on the stack.
+ * A sequence is a token (literal length << 4 | match length - 4),
+ * extra length bytes of 255, the literals, a 16-bit LE offset and
+ * extra match length bytes; the last sequence has literals only.
+ */
+
+#define LZ_MIN_MATCH 4
+#define LZ_HASH_LOG 14
+#define LZ_MAX_OFFSET 65535
+
+/* Worst-case compressed size of n bytes */
+#define LZ_BOUND(n) ((n) + (n) / 255 + 16)
+
+/* Compress size bytes of src into dst; compressed size, or -1 if it does not fit capacity */
+long lz_compress(const unsigned char *src, long size, unsigned char *dst, long capacity);
+
+/* Decompress size bytes of src into dst; decompressed size, or -1 on corrupt input */
+long lz_decompress(const unsigned char *src, long size, unsigned char *dst, long capacity);
+
+#endif
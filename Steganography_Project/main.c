@@ -4,23 +4,258 @@ Date        : 25-07-2025
 Description : Steganography
 */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "encode.h"
-#include "decode.h"
+#include "stego.h"
 #include "types.h"
 #include "common.h"
+#include "parallel.h"
+#include "batch.h"
+#include "analyze.h"
+#include "scan.h"
+#include "daemon.h"
+
+// Options that may appear anywhere after -e/-d
+typedef struct
+{
+    int threads;  /* -j N, 0 when not given */
+    int bits;     /* -k N, payload bits per carrier byte */
+    int compress; /* -z, compress the secret before embedding */
+    int crc;      /* cleared by --no-crc */
+    const char *key_file; /* -K file, NULL to fall back on $STEGO_KEY */
+    int json;     /* --json, analyzer, scanner and listing output as JSON */
+    int stats;    /* --stats, per-stage timings as JSON on stderr */
+    int quiet;    /* --quiet, failures only */
+    long range_offset; /* --range OFFSET[:LENGTH], decode only these payload bytes */
+    long range_length; /* 0: to the end */
+    int in_place; /* --in-place, encode into the source image itself */
+    FILE *progress; /* stdout, or stderr while stdout carries the output image or payload */
+    int pipeline; /* cleared by --no-pipeline: read, embed and write the data on one thread */
+    int scatter;  /* --scatter: spread the data over the image in the key's block order */
+    int fec;      /* --fec, Reed-Solomon code the data so a damaged image still decodes */
+} Options;
+
+// Remove options from argv, leaving the positional arguments in order
+// Returns the new argc, or -1 on a malformed option
+static int parse_options(int argc, char *argv[], Options *options)
+{
+    int i, n = 2;
+    char *end;
+
+    options->threads = 0;
+    options->bits = 1;
+    options->compress = 0;
+    options->crc = 1;
+    options->key_file = NULL;
+    options->json = 0;
+    options->stats = 0;
+    options->quiet = 0;
+    options->range_offset = 0;
+    options->range_length = 0;
+    options->in_place = 0;
+    options->progress = stdout;
+    options->pipeline = 1;
+    options->scatter = 0;
+    options->fec = 0;
+    for (i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0)
+        {
+            if (i + 1 >= argc)
+                return -1;
+            options->threads = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || options->threads < 1 || options->threads > MAX_THREADS)
+                return -1;
+        }
+        else if (strcmp(argv[i], "-k") == 0)
+        {
+            if (i + 1 >= argc)
+                return -1;
+            options->bits = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || (options->bits != 1 && options->bits != 2 && options->bits != 4))
+                return -1;
+        }
+        else if (strcmp(argv[i], "-z") == 0)
+        {
+            options->compress = 1;
+        }
+        else if (strcmp(argv[i], "--no-crc") == 0)
+        {
+            options->crc = 0;
+        }
+        else if (strcmp(argv[i], "-K") == 0)
+        {
+            if (i + 1 >= argc)
+                return -1;
+            options->key_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--json") == 0)
+        {
+            options->json = 1;
+        }
+        else if (strcmp(argv[i], "--stats") == 0)
+        {
+            options->stats = 1;
+        }
+        else if (strcmp(argv[i], "--quiet") == 0)
+        {
+            options->quiet = 1;
+        }
+        else if (strcmp(argv[i], "--no-pipeline") == 0)
+        {
+            options->pipeline = 0;
+        }
+        else if (strcmp(argv[i], "--scatter") == 0)
+        {
+            options->scatter = 1;
+        }
+        else if (strcmp(argv[i], "--fec") == 0)
+        {
+            options->fec = 1;
+        }
+        else if (strcmp(argv[i], "--in-place") == 0)
+        {
+            options->in_place = 1;
+        }
+        else if (strcmp(argv[i], "--range") == 0)
+        {
+            if (i + 1 >= argc)
+                return -1;
+            options->range_offset = strtol(argv[++i], &end, 10);
+            if (*end == ':')
+                options->range_length = strtol(end + 1, &end, 10);
+            if (*end != '\0' || options->range_offset < 0 || options->range_length < 0)
+                return -1;
+        }
+        else
+        {
+            argv[n++] = argv[i];
+        }
+    }
+    argv[n] = NULL;
+    return n;
+}
+
+// Library status lines: progress on options->progress (unless --quiet), failures on stderr
+static void print_log(void *user, int is_error, const char *message)
+{
+    const Options *options = user;
+
+    if (is_error || !options->quiet)
+        fputs(message, is_error ? stderr : options->progress);
+}
+
+// What -l has printed so far
+typedef struct
+{
+    int json;
+    int count;
+    long total;
+} EntryPrinter;
+
+// -l: one line, or one JSON object, per archive entry
+static int print_entry(void *user, const StegoEntry *entry)
+{
+    EntryPrinter *printer = user;
+
+    if (printer->json)
+    {
+        printf("%s\n  {\"name\": ", printer->count ? "," : "");
+        json_print_string(entry->name);
+        printf(", \"size\": %ld, \"offset\": %ld, \"crc\": \"%08x\"}", entry->size, entry->offset, entry->crc);
+    }
+    else
+    {
+        printf("📄 %12ld  %s\n", entry->size, entry->name);
+    }
+    printer->count++;
+    printer->total += entry->size;
+    return 0;
+}
+
+// --stats: one JSON object on stderr, every stage listed so runs diff cleanly
+static void print_stats(const char *op, StegoError err, const StegoStats *stats)
+{
+    int i;
+
+    fprintf(stderr, "{\"op\": \"%s\", \"status\": \"%s\", \"seconds\": %.6f, \"io_counted\": %s, \"stages\": {", op,
+            err == e_stego_ok ? "ok" : "failed", stats->total, stats->io_counted ? "true" : "false");
+    for (i = 0; i < STEGO_STAGE_COUNT; i++)
+    {
+        fprintf(stderr,
+                "%s\"%s\": {\"seconds\": %.6f, \"read_bytes\": %ld, \"write_bytes\": %ld, \"read_calls\": %ld, "
+                "\"write_calls\": %ld}",
+                i ? ", " : "", stego_stage_name(i), stats->seconds[i], stats->read_bytes[i], stats->write_bytes[i],
+                stats->read_calls[i], stats->write_calls[i]);
+    }
+    fprintf(stderr, "}}\n");
+}
 
 int main(int argc, char *argv[])
 {
-    // Declare structures
-    EncodeInfo encodeInfo;
-    DecodeInfo decodeInfo;
+    Options options;
+    StegoOptions stego_options;
+    StegoStats stats;
+    StegoError err;
+    unsigned char key[STEGO_KEY_SIZE];
 
     // Check minimum arguments
     if (argc < 2)
     {
         // Print usage info
-        printf("Encoding: ./a.out -e <src_image.bmp> <secret_file.txt|.c|.sh> [optional_image.bmp]\n");
-        printf("Decoding: ./a.out -d <stego_image.bmp> [optional_secret_file]\n");
+        printf("Encoding: ./a.out -e <src_image.bmp|-> <secret_file.txt|.c|.sh|-> [optional_image.bmp|-] [-j threads] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec] [--in-place] [--no-pipeline] [--stats] [--quiet]\n");
+        printf("Decoding: ./a.out -d <stego_image.bmp|-> [optional_secret_file|-] [-j threads] [-K keyfile] [--range OFFSET[:LENGTH]] [--no-pipeline] [--stats] [--quiet]\n");
+        printf("Batch   : ./a.out -b <manifest.txt> [-j workers] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec]\n");
+        printf("Analyze : ./a.out -a [image.bmp ...] [--json]  (paths from stdin when none are given)\n");
+        printf("Scan    : ./a.out -s <image.bmp|directory> ... [-j threads] [--json]\n");
+        printf("Archive : ./a.out -c <src_image.bmp> <output_image.bmp> <file> ... [-k 1|2|4] [--no-crc] [--stats] [--quiet]\n");
+        printf("List    : ./a.out -l <stego_image.bmp> [--json]\n");
+        printf("Extract : ./a.out -x <stego_image.bmp> <name> [output_file|-] [-j threads] [--stats] [--quiet]\n");
+        printf("Daemon  : ./a.out -D <socket> [-j workers] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec]\n");
+        return 1;
+    }
+
+    // Separate options from file arguments
+    argc = parse_options(argc, argv, &options);
+    if (argc < 0)
+    {
+        fprintf(stderr, "Error:❌ -j expects a thread count between 1 and %d, -k one of 1, 2 or 4, --range OFFSET[:LENGTH].\n",
+                MAX_THREADS);
+        return 1;
+    }
+
+    // The library is silent unless told where to print
+    stego_set_log(print_log, &options);
+    stego_options_init(&stego_options);
+    stego_options.threads = options.threads ? options.threads : 1;
+    stego_options.bits = options.bits;
+    stego_options.compress = options.compress;
+    stego_options.crc = options.crc;
+    stego_options.range_offset = options.range_offset;
+    stego_options.range_length = options.range_length;
+    stego_options.pipeline = options.pipeline;
+    stego_options.scatter = options.scatter;
+    stego_options.fec = options.fec;
+    if (options.stats)
+        stego_options.stats = &stats;
+
+    // A key encrypts when encoding and opens encrypted images when decoding
+    if (options.key_file != NULL || getenv("STEGO_KEY") != NULL)
+    {
+        err = stego_load_key(options.key_file, key);
+        if (err != e_stego_ok)
+        {
+            fprintf(stderr, "Error:❌ Unable to load the key from %s: expected 32 bytes or 64 hex digits.\n",
+                    options.key_file ? options.key_file : "STEGO_KEY");
+            return 1;
+        }
+        stego_options.key = key;
+    }
+    if (options.scatter && stego_options.key == NULL)
+    {
+        fprintf(stderr, "Error:❌ --scatter orders the data by a key: give one with -K or STEGO_KEY.\n");
         return 1;
     }
 
@@ -32,34 +267,42 @@ int main(int argc, char *argv[])
         // Check encoding arguments
         if (argc >= 4 && argc <= 5)
         {
-            // Validate encoding args
-            if (read_and_validate_encode_args(argv, &encodeInfo) == e_failure)
+            // In place the source is the output: no stego image name
+            if (options.in_place && argc != 4)
             {
-                fprintf(stderr, "Error:❌ Invalid encoding arguments.\n");
+                fprintf(stderr, "Error:❌ --in-place writes into %s: no output image may be given.\n", argv[2]);
                 return 1;
             }
 
-            // Do encoding
-            if (do_encoding(&encodeInfo) == e_failure)
+            // An image written to stdout must not be interleaved with progress lines
+            if (argc == 5 && strcmp(argv[4], STREAM_NAME) == 0)
+                options.progress = stderr;
+
+            // Validate and encode through the library
+            if (options.in_place)
+                err = stego_encode_in_place(argv[2], argv[3], &stego_options);
+            else
+                err = stego_encode_file(argv[2], argv[3], argv[4], &stego_options);
+            if (options.stats)
+                print_stats("encode", err, &stats);
+            if (err != e_stego_ok)
             {
-                close_encode_files(&encodeInfo);
-                fprintf(stderr, "Error:❌ Encoding failed.\n");
+                fprintf(stderr, "Error:❌ Encoding failed: %s.\n", stego_strerror(err));
                 return 1;
             }
-            else
+            if (!options.quiet)
             {
-                close_encode_files(&encodeInfo);
-                printf("--------------------------------------------------\n");
-                printf("    ✅ INFO: ## Encoding Done Successfully ## \n");
-                printf("--------------------------------------------------\n");
-                return 0;
+                fprintf(options.progress, "--------------------------------------------------\n");
+                fprintf(options.progress, "    ✅ INFO: ## Encoding Done Successfully ## \n");
+                fprintf(options.progress, "--------------------------------------------------\n");
             }
+            return 0;
         }
         else
         {
             // Invalid encoding argument count
             fprintf(stderr, "Error: Invalid number of arguments for encoding.\n");
-            printf("Encoding: ./a.out -e <src_image.bmp> <secret.txt> [output_image.bmp]\n");
+            printf("Encoding: ./a.out -e <src_image.bmp|-> <secret.txt|-> [output_image.bmp|-] [-j threads] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec] [--in-place] [--no-pipeline] [--stats] [--quiet]\n");
             return 1;
         }
     }
@@ -68,46 +311,181 @@ int main(int argc, char *argv[])
         // Check decoding arguments
         if (argc >= 3 && argc <= 4)
         {
-            // Validate decoding args
-            if (read_and_validate_decode_args(argv, &decodeInfo) == e_failure)
-            {
-                fprintf(stderr, "Error:❌ Invalid decoding arguments.\n");
-                return 1;
-            }
+            // Same for a payload written to stdout
+            if (argc == 4 && strcmp(argv[3], STREAM_NAME) == 0)
+                options.progress = stderr;
 
-            // printf("[INFO] Arguments validated.\n");
-
-            // Do decoding
-            if (do_decoding(&decodeInfo) == e_failure)
+            // Validate and decode through the library
+            err = stego_decode_file(argv[2], argv[3], &stego_options);
+            if (options.stats)
+                print_stats("decode", err, &stats);
+            if (err != e_stego_ok)
             {
-                close_decode_files(&decodeInfo);
-                fprintf(stderr, "Error:❌ Decoding failed.\n");
+                fprintf(stderr, "Error:❌ Decoding failed: %s.\n", stego_strerror(err));
                 return 1;
             }
-            else
+            if (!options.quiet)
             {
-                close_decode_files(&decodeInfo);
-                printf("--------------------------------------------------\n");
-                printf("    ✅ INFO: ## Decoding Done Successfully ##\n");
-                printf("--------------------------------------------------\n");
-
-                return 0;
+                fprintf(options.progress, "--------------------------------------------------\n");
+                fprintf(options.progress, "    ✅ INFO: ## Decoding Done Successfully ##\n");
+                fprintf(options.progress, "--------------------------------------------------\n");
             }
+            return 0;
         }
         else
         {
             // Invalid decoding argument count
             fprintf(stderr, "Error:❌ Invalid number of arguments for decoding.\n");
-            printf("Decoding: ./a.out -d <stego_image.bmp> [output_secret.txt]\n");
+            printf("Decoding: ./a.out -d <stego_image.bmp|-> [output_secret.txt|-] [-j threads] [-K keyfile] [--range OFFSET[:LENGTH]] [--no-pipeline] [--stats] [--quiet]\n");
+            return 1;
+        }
+    }
+    else if (op_type == e_batch)
+    {
+        if (argc != 3)
+        {
+            fprintf(stderr, "Error:❌ Invalid number of arguments for batch.\n");
+            printf("Batch   : ./a.out -b <manifest.txt> [-j workers] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec]\n");
+            return 1;
+        }
+
+        // One worker per online CPU unless -j says otherwise
+        return run_batch(argv[2], options.threads ? options.threads : sysconf(_SC_NPROCESSORS_ONLN),
+                         &stego_options) == e_success ? 0 : 1;
+    }
+    else if (op_type == e_analyze)
+    {
+        // Headers only: covers are never opened for writing
+        return run_analyze(argv + 2, argc - 2, options.json) == e_success ? 0 : 1;
+    }
+    else if (op_type == e_scan)
+    {
+        if (argc < 3)
+        {
+            fprintf(stderr, "Error:❌ Nothing to scan.\n");
+            printf("Scan    : ./a.out -s <image.bmp|directory> ... [-j threads] [--json]\n");
+            return 1;
+        }
+
+        // -j sizes the thread pool used when io_uring is not available
+        return run_scan(argv + 2, argc - 2, options.threads ? options.threads : sysconf(_SC_NPROCESSORS_ONLN),
+                        options.json) == e_success ? 0 : 1;
+    }
+    else if (op_type == e_archive)
+    {
+        if (argc < 5)
+        {
+            fprintf(stderr, "Error:❌ Invalid number of arguments for archiving.\n");
+            printf("Archive : ./a.out -c <src_image.bmp> <output_image.bmp> <file> ... [-k 1|2|4] [--no-crc] [--stats] [--quiet]\n");
+            return 1;
+        }
+
+        // Entries are seeked to by offset: no frames or stripes, so no -z, -K or --fec
+        if (options.compress || options.key_file != NULL || options.fec)
+        {
+            fprintf(stderr, "Error:❌ Archives are stored uncompressed, unencrypted and uncoded: drop -z, -K and --fec.\n");
             return 1;
         }
+        stego_options.key = NULL;
+        err = stego_archive_file(argv[2], argv + 4, argc - 4, argv[3], &stego_options);
+        if (options.stats)
+            print_stats("archive", err, &stats);
+        if (err != e_stego_ok)
+        {
+            fprintf(stderr, "Error:❌ Archiving failed: %s.\n", stego_strerror(err));
+            return 1;
+        }
+        if (!options.quiet)
+        {
+            printf("--------------------------------------------------\n");
+            printf("    ✅ INFO: ## Archiving Done Successfully ## \n");
+            printf("--------------------------------------------------\n");
+        }
+        return 0;
+    }
+    else if (op_type == e_list)
+    {
+        EntryPrinter printer = {options.json, 0, 0};
+
+        if (argc != 3)
+        {
+            fprintf(stderr, "Error:❌ Invalid number of arguments for listing.\n");
+            printf("List    : ./a.out -l <stego_image.bmp> [--json]\n");
+            return 1;
+        }
+
+        // The listing is the output: no progress lines around it
+        options.quiet = 1;
+        if (printer.json)
+            putchar('[');
+        err = stego_list_file(argv[2], print_entry, &printer);
+        if (printer.json)
+            printf("%s]\n", printer.count ? "\n" : "");
+        else if (err == e_stego_ok)
+            printf("📦 %d file(s), %ld bytes\n", printer.count, printer.total);
+        if (err != e_stego_ok)
+        {
+            fprintf(stderr, "Error:❌ Listing failed: %s.\n", stego_strerror(err));
+            return 1;
+        }
+        return 0;
+    }
+    else if (op_type == e_extract)
+    {
+        if (argc < 4 || argc > 5)
+        {
+            fprintf(stderr, "Error:❌ Invalid number of arguments for extracting.\n");
+            printf("Extract : ./a.out -x <stego_image.bmp> <name> [output_file|-] [-j threads] [--stats] [--quiet]\n");
+            return 1;
+        }
+
+        // Same for an entry written to stdout
+        if (argc == 5 && strcmp(argv[4], STREAM_NAME) == 0)
+            options.progress = stderr;
+
+        // Only the table of contents and this entry's carrier bytes are decoded
+        err = stego_extract_file(argv[2], argv[3], argv[4], &stego_options);
+        if (options.stats)
+            print_stats("extract", err, &stats);
+        if (err != e_stego_ok)
+        {
+            fprintf(stderr, "Error:❌ Extracting failed: %s.\n", stego_strerror(err));
+            return 1;
+        }
+        if (!options.quiet)
+        {
+            fprintf(options.progress, "--------------------------------------------------\n");
+            fprintf(options.progress, "    ✅ INFO: ## Extracting Done Successfully ## \n");
+            fprintf(options.progress, "--------------------------------------------------\n");
+        }
+        return 0;
+    }
+    else if (op_type == e_daemon)
+    {
+        if (argc != 3)
+        {
+            fprintf(stderr, "Error:❌ Invalid number of arguments for the daemon.\n");
+            printf("Daemon  : ./a.out -D <socket> [-j workers] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec]\n");
+            return 1;
+        }
+
+        // One worker per online CPU unless -j says otherwise; the encode options hold for every request
+        return run_daemon(argv[2], options.threads ? options.threads : sysconf(_SC_NPROCESSORS_ONLN),
+                          &stego_options) == e_success ? 0 : 1;
     }
     else
     {
         // Invalid option
-        fprintf(stderr, "Error:❌ Invalid operation type. Use -e or -d.\n");
-        printf("Encoding: ./a.out -e <src_image.bmp> <secret.txt> [output_image.bmp]\n");
-        printf("Decoding: ./a.out -d <stego_image.bmp> [output_secret.txt]\n");
+        fprintf(stderr, "Error:❌ Invalid operation type. Use -e, -d, -b, -a, -s, -c, -l, -x or -D.\n");
+        printf("Encoding: ./a.out -e <src_image.bmp|-> <secret.txt|-> [output_image.bmp|-] [-j threads] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec] [--in-place] [--no-pipeline] [--stats] [--quiet]\n");
+        printf("Decoding: ./a.out -d <stego_image.bmp|-> [output_secret.txt|-] [-j threads] [-K keyfile] [--range OFFSET[:LENGTH]] [--no-pipeline] [--stats] [--quiet]\n");
+        printf("Batch   : ./a.out -b <manifest.txt> [-j workers] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec]\n");
+        printf("Analyze : ./a.out -a [image.bmp ...] [--json]\n");
+        printf("Scan    : ./a.out -s <image.bmp|directory> ... [-j threads] [--json]\n");
+        printf("Archive : ./a.out -c <src_image.bmp> <output_image.bmp> <file> ... [-k 1|2|4] [--no-crc] [--stats] [--quiet]\n");
+        printf("List    : ./a.out -l <stego_image.bmp> [--json]\n");
+        printf("Extract : ./a.out -x <stego_image.bmp> <name> [output_file|-] [-j threads] [--stats] [--quiet]\n");
+        printf("Daemon  : ./a.out -D <socket> [-j workers] [-k 1|2|4] [-z] [--no-crc] [-K keyfile [--scatter]] [--fec]\n");
         return 1;
     }
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - multi-threaded data stage
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "parallel.h"
+#include "lsb_engine.h"
+#include "crc32c.h"
+#include "types.h"
+
+// One thread's share of the payload
+typedef struct
+{
+    const unsigned char *map; /* Source image mapping (embed only) */
+    const BmpLayout *layout;  /* Where the carrier bytes sit */
+    int fd_in;                /* Secret file (embed) or stego image (extract) */
+    int fd_out;               /* Stego image (embed) or output file (extract) */
+    long data_pos;            /* Carrier byte of payload byte 0 */
+    long first;               /* First payload byte of this slice */
+    long count;               /* Payload bytes in this slice */
+    int bits;                 /* Payload bits per carrier byte */
+    uint32_t crc;             /* CRC32C of this slice's payload */
+    Status status;
+} DataSlice;
+
+// Worker: read its part of the secret, embed it and write it in place
+static void *embed_worker(void *arg)
+{
+    DataSlice *slice = arg;
+    char *data = malloc(LSB_PAYLOAD_BLOCK);
+    char *block = malloc(LSB_CARRIER_BLOCK);
+    unsigned char *span = slice->layout->packed ? NULL : malloc(BMP_SPAN_SIZE(LSB_CARRIER_BLOCK));
+    long done, chunk, pos;
+
+    slice->status = e_failure;
+    if (data != NULL && block != NULL && (span != NULL || slice->layout->packed))
+    {
+        for (done = 0; done < slice->count; done += chunk)
+        {
+            chunk = slice->count - done;
+            if (chunk > LSB_PAYLOAD_BLOCK)
+                chunk = LSB_PAYLOAD_BLOCK;
+            pos = slice->first + done;
+
+            if (lsb_pread_full(slice->fd_in, data, chunk, pos) == e_failure ||
+                lsb_embed_at(slice->map, slice->layout, slice->fd_out, slice->data_pos + LSB_CARRIER_SIZE(pos, slice->bits),
+                             data, chunk, slice->bits, block, span, &slice->crc) == e_failure)
+                break;
+        }
+        if (done >= slice->count)
+            slice->status = e_success;
+    }
+
+    free(data);
+    free(block);
+    free(span);
+    return NULL;
+}
+
+// Worker: pread its carrier slice, extract it and pwrite it into the output
+static void *extract_worker(void *arg)
+{
+    DataSlice *slice = arg;
+    char *data = malloc(LSB_PAYLOAD_BLOCK);
+    char *block = malloc(LSB_CARRIER_BLOCK);
+    unsigned char *span = slice->layout->packed ? NULL : malloc(BMP_SPAN_SIZE(LSB_CARRIER_BLOCK));
+    long done, chunk, pos;
+
+    slice->status = e_failure;
+    if (data != NULL && block != NULL && (span != NULL || slice->layout->packed))
+    {
+        for (done = 0; done < slice->count; done += chunk)
+        {
+            chunk = slice->count - done;
+            if (chunk > LSB_PAYLOAD_BLOCK)
+                chunk = LSB_PAYLOAD_BLOCK;
+            pos = slice->first + done;
+
+            if (lsb_extract_at(slice->fd_in, slice->layout, slice->data_pos + LSB_CARRIER_SIZE(pos, slice->bits),
+                               data, chunk, slice->bits, block, span, &slice->crc) == e_failure ||
+                lsb_pwrite_full(slice->fd_out, data, chunk, pos) == e_failure)
+                break;
+        }
+        if (done >= slice->count)
+            slice->status = e_success;
+    }
+
+    free(data);
+    free(block);
+    free(span);
+    return NULL;
+}
+
+// Cut size payload bytes into at most threads slices of whole blocks, run and join them,
+// and chain the slice CRCs in payload order
+static Status run_slices(void *(*worker)(void *), const unsigned char *map, const BmpLayout *layout,
+                         int fd_in, int fd_out, long data_pos, long size, int bits, int threads, uint32_t *crc)
+{
+    DataSlice slices[MAX_THREADS];
+    pthread_t tids[MAX_THREADS];
+    long blocks = (size + LSB_PAYLOAD_BLOCK - 1) / LSB_PAYLOAD_BLOCK;
+    long per_slice;
+    int i, count, started;
+    Status ret = e_success;
+
+    *crc = 0;
+    if (size == 0)
+        return e_success;
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads > blocks)
+        threads = blocks;
+
+    // Round slices up to whole payload blocks so no block straddles two threads
+    per_slice = ((blocks + threads - 1) / threads) * LSB_PAYLOAD_BLOCK;
+    count = (size + per_slice - 1) / per_slice;
+
+    for (started = 0; started < count; started++)
+    {
+        slices[started].map = map;
+        slices[started].layout = layout;
+        slices[started].fd_in = fd_in;
+        slices[started].fd_out = fd_out;
+        slices[started].data_pos = data_pos;
+        slices[started].bits = bits;
+        slices[started].crc = 0;
+        slices[started].first = started * per_slice;
+        slices[started].count = size - slices[started].first;
+        if (slices[started].count > per_slice)
+            slices[started].count = per_slice;
+
+        if (pthread_create(&tids[started], NULL, worker, &slices[started]) != 0)
+        {
+            ret = e_failure;
+            break;
+        }
+    }
+
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(tids[i], NULL);
+        if (slices[i].status == e_failure)
+            ret = e_failure;
+        *crc = crc32c_combine(*crc, slices[i].crc, slices[i].count);
+    }
+    return ret;
+}
+
+// Fan the encoder data stage out over threads
+Status parallel_embed(const unsigned char *map, const BmpLayout *layout, int fd_secret, int fd_dest,
+                      long data_pos, long size, int bits, int threads, uint32_t *crc)
+{
+    return run_slices(embed_worker, map, layout, fd_secret, fd_dest, data_pos, size, bits, threads, crc);
+}
+
+// Fan the decoder data stage out over threads
+Status parallel_extract(int fd_stego, const BmpLayout *layout, int fd_out, long data_pos, long size, int bits,
+                        int threads, uint32_t *crc)
+{
+    return run_slices(extract_worker, NULL, layout, fd_stego, fd_out, data_pos, size, bits, threads, crc);
+}
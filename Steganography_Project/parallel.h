@@ -0,0 +1,27 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdint.h>
+#include "types.h" // Contains user defined types
+#include "bmp.h"
+
+/*
+ * Multi-threaded data stage
+ * At bits per carrier byte, payload byte i always lives in carrier bytes
+ * [data_pos + i * 8 / bits, data_pos + (i + 1) * 8 / bits), so the
+ * payload and its carrier region can be cut into independent per-thread slices
+ */
+
+#define MAX_THREADS 256
+
+/* Embed size bytes of fd_secret from carrier byte data_pos of map, pwrite-ing the slices to fd_dest;
+ * *crc gets the CRC32C of the payload */
+Status parallel_embed(const unsigned char *map, const BmpLayout *layout, int fd_secret, int fd_dest,
+                      long data_pos, long size, int bits, int threads, uint32_t *crc);
+
+/* Extract size bytes from carrier byte data_pos of fd_stego, pwrite-ing the slices into fd_out;
+ * *crc gets the CRC32C of the payload */
+Status parallel_extract(int fd_stego, const BmpLayout *layout, int fd_out, long data_pos, long size, int bits,
+                        int threads, uint32_t *crc);
+
+#endif
@@ -0,0 +1,563 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - stego scanner over files and directory trees
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "scan.h"
+#include "analyze.h"
+#include "parallel.h"
+#include "stego.h"
+#include "types.h"
+
+// -DSCAN_NO_URING builds with the thread pool only
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && !defined(SCAN_NO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define SCAN_URING 1
+#endif
+
+typedef struct
+{
+    char *path;
+    long file_size;
+    int fd;            /* Open descriptor while its read is in flight */
+    long got;          /* Bytes read, -errno on failure */
+    StegoError err;
+    StegoProbe probe;
+} ScanFile;
+
+#ifdef SCAN_URING
+// Submission and completion rings shared with the kernel, no liburing needed
+typedef struct
+{
+    int fd;
+    unsigned tail;     /* Our copy of the submission tail */
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_map;
+    void *cq_map;
+    size_t sq_size;
+    size_t cq_size;
+    size_t sqes_size;
+} Ring;
+#endif
+
+typedef struct
+{
+    ScanFile files[SCAN_BATCH];
+    int count;
+    int next;          /* Next file for a pool thread, taken atomically */
+    unsigned char *buffers;  /* STEGO_PROBE_SIZE bytes per file */
+    int workers;
+    int json;
+    int first;         /* No comma before the next JSON entry */
+    long hidden;
+    long clean;
+    long suspect;      /* Magic string matched but the fields did not */
+    long failed;
+#ifdef SCAN_URING
+    Ring ring;
+    int use_ring;
+#endif
+} Scanner;
+
+// nftw() takes no user pointer
+static Scanner *walk_scanner;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Read the fields out of the prefix in head, going back to the file for more when they lie beyond it
+static void probe_file(ScanFile *file, const unsigned char *head)
+{
+    unsigned char *more;
+    size_t needed;
+    ssize_t got;
+    int fd;
+
+    if (file->got < 0)
+    {
+        file->err = e_stego_io;
+        return;
+    }
+    file->err = stego_probe(head, file->got, file->file_size, &file->probe, &needed);
+    if (file->err != e_stego_buffer_small)
+        return;
+
+    // Pixels far behind the headers: rare, so a plain pread
+    file->err = e_stego_io;
+    more = malloc(needed);
+    fd = open(file->path, O_RDONLY | O_CLOEXEC);
+    if (more != NULL && fd >= 0)
+    {
+        got = pread(fd, more, needed, 0);
+        if (got >= 0)
+            file->err = stego_probe(more, got, file->file_size, &file->probe, &needed);
+        if (file->err == e_stego_buffer_small)
+            file->err = e_stego_io;
+    }
+    if (fd >= 0)
+        close(fd);
+    free(more);
+}
+
+// Thread pool: every thread takes the next file of the batch until none are left
+static void *pool_worker(void *arg)
+{
+    Scanner *scanner = arg;
+    ScanFile *file;
+    unsigned char *head;
+    int i;
+
+    while ((i = __atomic_fetch_add(&scanner->next, 1, __ATOMIC_RELAXED)) < scanner->count)
+    {
+        file = &scanner->files[i];
+        head = scanner->buffers + (size_t)i * STEGO_PROBE_SIZE;
+        file->fd = open(file->path, O_RDONLY | O_CLOEXEC);
+        if (file->fd < 0)
+        {
+            file->got = -errno;
+        }
+        else
+        {
+            file->got = pread(file->fd, head, STEGO_PROBE_SIZE, 0);
+            if (file->got < 0)
+                file->got = -errno;
+            close(file->fd);
+        }
+        probe_file(file, head);
+    }
+    return NULL;
+}
+
+static void pool_scan(Scanner *scanner)
+{
+    pthread_t tids[MAX_THREADS];
+    int i, started;
+
+    scanner->next = 0;
+    for (started = 0; started < scanner->workers - 1; started++)
+    {
+        if (pthread_create(&tids[started], NULL, pool_worker, scanner) != 0)
+            break;
+    }
+    // This thread works too, so a failed pthread_create only costs speed
+    pool_worker(scanner);
+    for (i = 0; i < started; i++)
+        pthread_join(tids[i], NULL);
+}
+
+#ifdef SCAN_URING
+static Status ring_init(Ring *ring, unsigned entries)
+{
+    struct io_uring_params params;
+
+    memset(&params, 0, sizeof(params));
+    ring->fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0)
+        return e_failure;
+
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring->cq_size > ring->sq_size)
+            ring->sq_size = ring->cq_size;
+        ring->cq_size = ring->sq_size;
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    ring->sq_map = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                        IORING_OFF_SQ_RING);
+    ring->cq_map = ring->sq_map;
+    if (ring->sq_map != MAP_FAILED && !(params.features & IORING_FEAT_SINGLE_MMAP))
+        ring->cq_map = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                            IORING_OFF_CQ_RING);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                      IORING_OFF_SQES);
+    if (ring->sq_map == MAP_FAILED || ring->cq_map == MAP_FAILED || ring->sqes == MAP_FAILED)
+    {
+        // Only the successful mappings are undone
+        if (ring->sqes != MAP_FAILED)
+            munmap(ring->sqes, ring->sqes_size);
+        if (ring->cq_map != MAP_FAILED && ring->cq_map != ring->sq_map)
+            munmap(ring->cq_map, ring->cq_size);
+        if (ring->sq_map != MAP_FAILED)
+            munmap(ring->sq_map, ring->sq_size);
+        close(ring->fd);
+        return e_failure;
+    }
+
+    ring->sq_tail = (unsigned *)((char *)ring->sq_map + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)((char *)ring->sq_map + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)((char *)ring->sq_map + params.sq_off.array);
+    ring->cq_head = (unsigned *)((char *)ring->cq_map + params.cq_off.head);
+    ring->cq_tail = (unsigned *)((char *)ring->cq_map + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)((char *)ring->cq_map + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)((char *)ring->cq_map + params.cq_off.cqes);
+    ring->tail = *ring->sq_tail;
+    return e_success;
+}
+
+static void ring_free(Ring *ring)
+{
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_map != ring->sq_map)
+        munmap(ring->cq_map, ring->cq_size);
+    munmap(ring->sq_map, ring->sq_size);
+    close(ring->fd);
+}
+
+// Next free submission entry, cleared
+static struct io_uring_sqe *ring_get(Ring *ring, unsigned long long user_data)
+{
+    unsigned index = ring->tail++ & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+
+    ring->sq_array[index] = index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = user_data;
+    return sqe;
+}
+
+// Hand count queued entries to the kernel in one call and collect their results
+static Status ring_run(Ring *ring, unsigned count, void (*done)(Scanner *, unsigned long long, int), Scanner *scanner)
+{
+    struct io_uring_cqe *cqe;
+    unsigned head, submitted = 0, reaped = 0;
+    int ret;
+
+    __atomic_store_n(ring->sq_tail, ring->tail, __ATOMIC_RELEASE);
+    while (reaped < count)
+    {
+        ret = syscall(__NR_io_uring_enter, ring->fd, count - submitted, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (ret < 0 && errno != EINTR)
+            return e_failure;
+        if (ret > 0)
+            submitted += ret;
+
+        head = *ring->cq_head;
+        while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+        {
+            cqe = &ring->cqes[head++ & *ring->cq_mask];
+            done(scanner, cqe->user_data, cqe->res);
+            reaped++;
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+    return e_success;
+}
+
+static void opened(Scanner *scanner, unsigned long long user_data, int res)
+{
+    scanner->files[user_data].fd = res;
+}
+
+// Reads are even, the closes linked after them odd; a closed file's fd is no longer ours
+static void read_or_closed(Scanner *scanner, unsigned long long user_data, int res)
+{
+    if (!(user_data & 1))
+        scanner->files[user_data >> 1].got = res;
+    else
+        scanner->files[user_data >> 1].fd = -1;
+}
+
+// Close what the ring opened and has not closed yet, before the pool opens it all again
+static void close_opened(Scanner *scanner)
+{
+    int i;
+
+    for (i = 0; i < scanner->count; i++)
+    {
+        if (scanner->files[i].fd >= 0)
+            close(scanner->files[i].fd);
+        scanner->files[i].fd = -1;
+    }
+}
+
+// Opens for the whole batch in one submission, then reads each followed by its close in a second.
+// e_failure when the kernel lacks these operations: the caller falls back on the pool
+static Status ring_scan(Scanner *scanner)
+{
+    struct io_uring_sqe *sqe;
+    ScanFile *file;
+    unsigned queued = 0;
+    int i;
+
+    for (i = 0; i < scanner->count; i++)
+    {
+        sqe = ring_get(&scanner->ring, i);
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (unsigned long)scanner->files[i].path;
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+    }
+    if (ring_run(&scanner->ring, scanner->count, opened, scanner) == e_failure)
+    {
+        close_opened(scanner);
+        return e_failure;
+    }
+
+    for (i = 0; i < scanner->count; i++)
+    {
+        file = &scanner->files[i];
+        if (file->fd == -EINVAL || file->fd == -EOPNOTSUPP)
+        {
+            close_opened(scanner);
+            return e_failure;
+        }
+        if (file->fd < 0)
+        {
+            file->got = file->fd;
+            continue;
+        }
+
+        // A hard link closes the file even when the read fails or comes up short
+        sqe = ring_get(&scanner->ring, (unsigned long long)i << 1);
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = file->fd;
+        sqe->addr = (unsigned long)(scanner->buffers + (size_t)i * STEGO_PROBE_SIZE);
+        sqe->len = STEGO_PROBE_SIZE;
+        sqe->off = 0;
+        sqe->flags = IOSQE_IO_HARDLINK;
+        sqe = ring_get(&scanner->ring, (unsigned long long)i << 1 | 1);
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = file->fd;
+        queued += 2;
+    }
+    if (queued > 0 && ring_run(&scanner->ring, queued, read_or_closed, scanner) == e_failure)
+    {
+        close_opened(scanner);
+        return e_failure;
+    }
+
+    for (i = 0; i < scanner->count; i++)
+        probe_file(&scanner->files[i], scanner->buffers + (size_t)i * STEGO_PROBE_SIZE);
+    return e_success;
+}
+#endif
+
+// One line (or JSON entry) per file
+static void report_file(Scanner *scanner, ScanFile *file)
+{
+    StegoProbe *probe = &file->probe;
+
+    if (file->err == e_stego_ok)
+        scanner->hidden++;
+    else if (file->err == e_stego_not_stego)
+        scanner->clean++;
+    else if (file->err == e_stego_corrupt)
+        scanner->suspect++;
+    else
+        scanner->failed++;
+
+    if (scanner->json)
+    {
+        printf("%s\n  {\"file\": ", scanner->first ? "" : ",");
+        scanner->first = 0;
+        json_print_string(file->path);
+        // A streamed payload is always framed, compressed or not: say so only as "streamed", as the text does
+        if (file->err == e_stego_ok)
+        {
+            printf(", \"stego\": true, \"size\": %ld, \"extn\": ", probe->size);
+            json_print_string(probe->extn);
+            printf(", \"bits\": %d, \"compressed\": %s, \"crc\": %s, \"encrypted\": %s, \"archive\": %s, "
+                   "\"streamed\": %s, \"scattered\": %s, \"fec\": %s}",
+                   probe->bits, probe->compressed && !probe->streamed ? "true" : "false", probe->crc ? "true" : "false",
+                   probe->encrypted ? "true" : "false", probe->archive ? "true" : "false",
+                   probe->streamed ? "true" : "false", probe->scattered ? "true" : "false",
+                   probe->fec ? "true" : "false");
+        }
+        else if (file->err == e_stego_not_stego || file->err == e_stego_corrupt)
+        {
+            printf(", \"stego\": false%s}", file->err == e_stego_corrupt ? ", \"suspect\": true" : "");
+        }
+        else
+        {
+            printf(", \"error\": ");
+            json_print_string(stego_strerror(file->err));
+            putchar('}');
+        }
+    }
+    else if (file->err == e_stego_ok && probe->streamed)
+    {
+        printf("🔐 %s: streamed, %s, %d bit(s) per byte%s%s%s%s\n", file->path,
+               probe->extn[0] ? probe->extn : "no extension", probe->bits,
+               probe->crc ? ", crc" : "", probe->encrypted ? ", encrypted" : "", probe->scattered ? ", scattered" : "",
+               probe->fec ? ", fec" : "");
+    }
+    else if (file->err == e_stego_ok)
+    {
+        printf("🔐 %s: %ld bytes, %s, %d bit(s) per byte%s%s%s%s%s\n", file->path, probe->size,
+               probe->archive ? "archive" : probe->extn[0] ? probe->extn : "no extension", probe->bits,
+               probe->compressed ? ", compressed" : "", probe->crc ? ", crc" : "", probe->encrypted ? ", encrypted" : "",
+               probe->scattered ? ", scattered" : "", probe->fec ? ", fec" : "");
+    }
+    else if (file->err == e_stego_not_stego)
+    {
+        printf("⬜ %s: no hidden data\n", file->path);
+    }
+    else if (file->err == e_stego_corrupt)
+    {
+        // Two bytes of magic match by chance about once in 65536 clean images
+        printf("⚠️ %s: magic string present, but the hidden fields are invalid\n", file->path);
+    }
+    else
+    {
+        fflush(stdout);
+        fprintf(stderr, "❌ %s: %s\n", file->path, stego_strerror(file->err));
+    }
+}
+
+// Read, probe and report the files collected so far
+static void scan_batch(Scanner *scanner)
+{
+    int i;
+
+    if (scanner->count == 0)
+        return;
+#ifdef SCAN_URING
+    if (scanner->use_ring && ring_scan(scanner) == e_failure)
+    {
+        // Old kernel: this batch and the rest go through the pool
+        ring_free(&scanner->ring);
+        scanner->use_ring = 0;
+    }
+    if (!scanner->use_ring)
+        pool_scan(scanner);
+#else
+    pool_scan(scanner);
+#endif
+
+    for (i = 0; i < scanner->count; i++)
+    {
+        report_file(scanner, &scanner->files[i]);
+        free(scanner->files[i].path);
+    }
+    scanner->count = 0;
+}
+
+static void add_file(Scanner *scanner, const char *path, long file_size)
+{
+    ScanFile *file = &scanner->files[scanner->count];
+
+    file->path = strdup(path);
+    if (file->path == NULL)
+    {
+        scanner->failed++;
+        return;
+    }
+    file->file_size = file_size;
+    file->fd = -1;
+    file->got = 0;
+    if (++scanner->count == SCAN_BATCH)
+        scan_batch(scanner);
+}
+
+// Directory entries: regular *.bmp files only, symlinks not followed
+static int walk_entry(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+    size_t len = strlen(path);
+
+    (void)ftw;
+    if (type == FTW_F && S_ISREG(st->st_mode) && len > 4 && strcasecmp(path + len - 4, ".bmp") == 0)
+    {
+        add_file(walk_scanner, path, st->st_size);
+    }
+    else if (type == FTW_DNR || type == FTW_NS)
+    {
+        fflush(stdout);
+        fprintf(stderr, "❌ %s: unable to read\n", path);
+        walk_scanner->failed++;
+    }
+    return 0;
+}
+
+Status run_scan(char *paths[], int count, int workers, int json)
+{
+    Scanner *scanner = calloc(1, sizeof(Scanner));
+    struct stat st;
+    double start = now_seconds();
+    const char *backend = "threads";
+    int i;
+
+    if (scanner == NULL || (scanner->buffers = malloc((size_t)SCAN_BATCH * STEGO_PROBE_SIZE)) == NULL)
+    {
+        fprintf(stderr, "ERROR:❌ Out of memory\n");
+        free(scanner);
+        return e_failure;
+    }
+    scanner->workers = workers < 1 ? 1 : workers > MAX_THREADS ? MAX_THREADS : workers;
+    scanner->json = json;
+    scanner->first = 1;
+#ifdef SCAN_URING
+    // Reads and closes of a batch go in together, so twice the batch in flight
+    scanner->use_ring = ring_init(&scanner->ring, 2 * SCAN_BATCH) == e_success;
+#endif
+
+    if (json)
+        putchar('[');
+    walk_scanner = scanner;
+    for (i = 0; i < count; i++)
+    {
+        if (stat(paths[i], &st) != 0)
+        {
+            fflush(stdout);
+            fprintf(stderr, "❌ %s: %s\n", paths[i], strerror(errno));
+            scanner->failed++;
+        }
+        else if (S_ISDIR(st.st_mode))
+        {
+            nftw(paths[i], walk_entry, 64, FTW_PHYS);
+        }
+        else
+        {
+            // Named files are scanned whatever their extension
+            add_file(scanner, paths[i], S_ISREG(st.st_mode) ? st.st_size : -1);
+        }
+    }
+    scan_batch(scanner);
+    if (json)
+        printf("%s]\n", scanner->first ? "" : "\n");
+    fflush(stdout);
+
+#ifdef SCAN_URING
+    if (scanner->use_ring)
+    {
+        backend = "io_uring";
+        ring_free(&scanner->ring);
+    }
+#endif
+    fprintf(stderr, "📦 %ld files: %ld with hidden data, %ld clean, %ld suspect, %ld failed in %.3f s (%s)\n",
+            scanner->hidden + scanner->clean + scanner->suspect + scanner->failed, scanner->hidden, scanner->clean,
+            scanner->suspect, scanner->failed, now_seconds() - start, backend);
+
+    i = scanner->failed == 0;
+    free(scanner->buffers);
+    free(scanner);
+    return i ? e_success : e_failure;
+}
@@ -0,0 +1,20 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "types.h" // Contains user defined types
+
+/*
+ * Stego scanner
+ * Walks files and directories (every *.bmp below them) and reports which
+ * images carry a payload, with its size and extension. Only the first
+ * STEGO_PROBE_SIZE bytes of each file are read, a batch of files at a
+ * time: through io_uring when the kernel offers it, by a pool of threads
+ * doing open/pread/close otherwise. Nothing is ever written.
+ */
+
+#define SCAN_BATCH 256 /* Files in flight at once */
+
+/* Scan paths as text or JSON with workers threads for the fallback; e_failure if a file was unreadable */
+Status run_scan(char *paths[], int count, int workers, int json);
+
+#endif
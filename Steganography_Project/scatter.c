@@ -0,0 +1,85 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - keyed carrier scattering
+*/
+#include <stdlib.h>
+#include <limits.h>
+#include "scatter.h"
+
+// Keystream nonce of the shuffle; frame nonces start with a random prefix, so they do not meet it
+static const unsigned char scatter_nonce[AEAD_NONCE_SIZE] = {'s', 'c', 'a', 't', 't', 'e', 'r'};
+
+// Little-endian, so the order does not depend on the host
+static uint64_t load64(const unsigned char *p)
+{
+    uint64_t v = 0;
+    int i;
+
+    for (i = 7; i >= 0; i--)
+        v = v << 8 | p[i];
+    return v;
+}
+
+Status scatter_init(ScatterMap *map, const unsigned char key[AEAD_KEY_SIZE], long start, long usable)
+{
+    unsigned char *stream;
+    uint32_t swap;
+    long i, j;
+
+    map->start = start;
+    map->count = (SCATTER_USABLE(start, usable) - start) / SCATTER_BLOCK;
+    // Less than a block of room: one block, which the capacity checks never let the data fill
+    if (map->count < 1)
+        map->count = 1;
+    map->order = malloc(map->count * sizeof(*map->order));
+    stream = calloc(map->count, 8);
+    if (map->order == NULL || stream == NULL)
+    {
+        free(stream);
+        scatter_free(map);
+        return e_failure;
+    }
+
+    // One 64-bit draw per step, scaled to [0, i] by a multiply (bias under 2^-32 for any image)
+    chacha20_xor(key, scatter_nonce, 0, stream, map->count * 8);
+    for (i = 0; i < map->count; i++)
+        map->order[i] = i;
+    for (i = map->count - 1; i > 0; i--)
+    {
+        j = (long)(((unsigned __int128)load64(stream + i * 8) * (i + 1)) >> 64);
+        swap = map->order[i];
+        map->order[i] = map->order[j];
+        map->order[j] = swap;
+    }
+    free(stream);
+    return e_success;
+}
+
+long scatter_pos(const ScatterMap *map, long pos)
+{
+    long offset = pos - map->start;
+
+    if (map->order == NULL || offset < 0 || offset >= map->count * SCATTER_BLOCK)
+        return pos;
+    return map->start + (long)map->order[offset / SCATTER_BLOCK] * SCATTER_BLOCK + offset % SCATTER_BLOCK;
+}
+
+long scatter_run(const ScatterMap *map, long pos)
+{
+    long offset = pos - map->start;
+
+    if (map->order == NULL)
+        return LONG_MAX;
+    if (offset < 0)
+        return -offset;
+    if (offset >= map->count * SCATTER_BLOCK)
+        return 0;
+    return SCATTER_BLOCK - offset % SCATTER_BLOCK;
+}
+
+void scatter_free(ScatterMap *map)
+{
+    free(map->order);
+    map->order = NULL;
+}
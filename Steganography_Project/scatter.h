@@ -0,0 +1,43 @@
+#ifndef SCATTER_H
+#define SCATTER_H
+
+#include <stdint.h>
+#include "types.h" // Contains user defined types
+#include "aead.h"
+
+/*
+ * Keyed carrier scattering
+ * The carrier after the header fields is cut into blocks of SCATTER_BLOCK
+ * bytes, visited in an order the key shuffles (Fisher-Yates driven by a
+ * ChaCha20 keystream) and front to back inside each block. The payload
+ * lands all over the pixel array, yet each block is still one span of
+ * the file, so reads and writes go in runs of 64 KiB rather than bytes.
+ * Carrier bytes after the last whole block are left as they are.
+ */
+
+#define SCATTER_BLOCK (64 * 1024)
+
+/* Carrier bytes up to start plus the whole blocks between start and usable */
+#define SCATTER_USABLE(start, usable) ((start) + ((usable) - (start)) / SCATTER_BLOCK * SCATTER_BLOCK)
+
+typedef struct
+{
+    long start;      /* First scattered carrier byte */
+    long count;      /* Whole blocks from start on */
+    uint32_t *order; /* Block i of the data sits at block order[i] of the image, NULL: not scattered */
+} ScatterMap;
+
+/* Shuffle the blocks of carrier bytes [start, usable) under key */
+Status scatter_init(ScatterMap *map, const unsigned char key[AEAD_KEY_SIZE], long start, long usable);
+
+/* Carrier byte of the image that holds carrier byte pos of the data (the same outside the blocks) */
+long scatter_pos(const ScatterMap *map, long pos);
+
+/* Carrier bytes from pos that stay in one piece: to the start or the end of its block
+ * (0 past the last block, LONG_MAX when not scattered) */
+long scatter_run(const ScatterMap *map, long pos);
+
+/* Release the block order */
+void scatter_free(ScatterMap *map);
+
+#endif
@@ -0,0 +1,99 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - single-producer/single-consumer ring
+*/
+#include <stdlib.h>
+#include <unistd.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include "spsc.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define cpu_relax() _mm_pause()
+#else
+#define cpu_relax() ((void)0)
+#endif
+
+// Polls before a waiting side goes to sleep: long enough to ride out a short stall
+#define SPSC_SPIN 2048
+
+Status spsc_init(SpscRing *ring, unsigned capacity)
+{
+    unsigned size = 1;
+
+    while (size < capacity)
+        size <<= 1;
+    ring->slots = malloc(size * sizeof(*ring->slots));
+    ring->mask = size - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->sleeping, 0);
+
+    // On one CPU the other side cannot move while we poll
+    ring->spin = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SPSC_SPIN : 0;
+    return ring->slots != NULL ? e_success : e_failure;
+}
+
+// Wait until *index (the other side's) is no longer seen: spin, then sleep on it
+static void wait_index(SpscRing *ring, _Atomic unsigned *index, unsigned seen)
+{
+    int i;
+
+    for (i = 0; i < ring->spin; i++)
+    {
+        if (atomic_load_explicit(index, memory_order_acquire) != seen)
+            return;
+        cpu_relax();
+    }
+
+    // Announce the sleep before the last look, so a move after it is sure to wake us
+    atomic_fetch_add(&ring->sleeping, 1);
+    if (atomic_load(index) == seen)
+        syscall(SYS_futex, (unsigned *)index, FUTEX_WAIT_PRIVATE, seen, NULL, NULL, 0);
+    atomic_fetch_sub(&ring->sleeping, 1);
+}
+
+// Our index moved: wake the other side if it went to sleep on it
+static void wake_index(SpscRing *ring, _Atomic unsigned *index)
+{
+    if (atomic_load(&ring->sleeping) > 0)
+        syscall(SYS_futex, (unsigned *)index, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+void spsc_push(SpscRing *ring, void *item)
+{
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head;
+
+    // Full while the consumer is a whole ring behind
+    while ((head = atomic_load_explicit(&ring->head, memory_order_acquire)) + ring->mask + 1 == tail)
+        wait_index(ring, &ring->head, head);
+
+    ring->slots[tail & ring->mask] = item;
+    atomic_store(&ring->tail, tail + 1);
+    wake_index(ring, &ring->tail);
+}
+
+void *spsc_pop(SpscRing *ring)
+{
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned tail;
+    void *item;
+
+    while ((tail = atomic_load_explicit(&ring->tail, memory_order_acquire)) == head)
+        wait_index(ring, &ring->tail, tail);
+
+    item = ring->slots[head & ring->mask];
+    atomic_store(&ring->head, head + 1);
+    wake_index(ring, &ring->head);
+    return item;
+}
+
+void spsc_free(SpscRing *ring)
+{
+    free(ring->slots);
+    ring->slots = NULL;
+}
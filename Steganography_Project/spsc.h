@@ -0,0 +1,37 @@
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stdatomic.h>
+#include "types.h" // Contains user defined types
+
+/*
+ * Lock-free single-producer/single-consumer ring of pointers
+ * Exactly one thread pushes and one thread pops. Each side owns one
+ * index and only reads the other, so the hot path is two atomic loads
+ * and a store. A side that finds the ring empty (or full) spins for a
+ * while, then sleeps on a futex until the other side moves.
+ */
+
+typedef struct
+{
+    void **slots;
+    unsigned mask;           /* Capacity - 1, capacity a power of two */
+    _Atomic unsigned head;   /* Slots popped so far, written by the consumer */
+    _Atomic unsigned tail;   /* Slots pushed so far, written by the producer */
+    _Atomic int sleeping;    /* A side is, or is about to be, in futex_wait */
+    int spin;                /* Polls before sleeping, 0 on a single CPU */
+} SpscRing;
+
+/* Allocate a ring of capacity slots (rounded up to a power of two) */
+Status spsc_init(SpscRing *ring, unsigned capacity);
+
+/* Producer: append item, waiting while the ring is full */
+void spsc_push(SpscRing *ring, void *item);
+
+/* Consumer: take the oldest item, waiting while the ring is empty */
+void *spsc_pop(SpscRing *ring);
+
+/* Release the slots */
+void spsc_free(SpscRing *ring);
+
+#endif
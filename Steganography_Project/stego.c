@@ -0,0 +1,616 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - embeddable library API
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "stego.h"
+#include "encode.h"
+#include "decode.h"
+#include "common.h"
+#include "lsb_kernels.h"
+#include "bmp.h"
+#include "archive.h"
+
+// Carrier bytes taken by everything but the payload (header fields are always 1 bit)
+#define HEADER_BYTES(extn_len) ((strlen(MAGIC_STRING) + 4 + (extn_len) + 4) * 8)
+
+static const StegoOptions default_options = {1, 1, 0, 1, NULL, NULL, 0, 0, 1, 0, 0};
+
+// Where stego_decode_buffer() collects the payload
+typedef struct
+{
+    unsigned char *out;
+    size_t out_size;
+    size_t total; /* Payload bytes seen, may exceed out_size */
+} BufferSink;
+
+// Where the decoder's FILE writes go when decoding to a sink
+typedef struct
+{
+    stego_sink_fn sink;
+    void *user;
+    int failed;
+} SinkCookie;
+
+const char *stego_strerror(StegoError err)
+{
+    switch (err)
+    {
+    case e_stego_ok:
+        return "success";
+    case e_stego_bad_args:
+        return "invalid arguments";
+    case e_stego_bad_image:
+        return "cover is not an uncompressed 24 or 32 bpp BMP";
+    case e_stego_no_capacity:
+        return "payload does not fit into the cover";
+    case e_stego_not_stego:
+        return "no hidden data found (magic string missing)";
+    case e_stego_corrupt:
+        return "hidden data is corrupt";
+    case e_stego_buffer_small:
+        return "output buffer too small";
+    case e_stego_sink_failed:
+        return "sink aborted the decode";
+    case e_stego_io:
+        return "read or write failure";
+    case e_stego_no_memory:
+        return "out of memory";
+    case e_stego_no_key:
+        return "hidden data is encrypted and no key was given";
+    case e_stego_auth_failed:
+        return "wrong key or tampered data";
+    case e_stego_is_archive:
+        return "hidden data is an archive: list it with -l, extract with -x";
+    case e_stego_not_archive:
+        return "hidden data is a single file, not an archive";
+    case e_stego_no_entry:
+        return "no such file in the archive";
+    }
+    return "unknown error";
+}
+
+const char *stego_stage_name(StegoStage stage)
+{
+    static const char *const names[STEGO_STAGE_COUNT] = {
+        "open", "check", "header", "magic", "extn_size", "extn", "size", "data", "crc", "remainder"};
+
+    return stage >= 0 && stage < STEGO_STAGE_COUNT ? names[stage] : "unknown";
+}
+
+void stego_options_init(StegoOptions *options)
+{
+    *options = default_options;
+}
+
+// Options as given or the defaults; NULL when they are out of range
+static const StegoOptions *check_options(const StegoOptions *options)
+{
+    if (options == NULL)
+        return &default_options;
+    if (options->threads < 1 || lsb_kernel_bits(options->bits) == NULL || options->range_offset < 0 ||
+        options->range_length < 0 || (options->scatter && options->key == NULL))
+        return NULL;
+    return options;
+}
+
+// Value of one hex digit, -1 for anything else
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+StegoError stego_load_key(const char *path, unsigned char key[STEGO_KEY_SIZE])
+{
+    char text[2 * STEGO_KEY_SIZE + 2];
+    const char *hex = text;
+    size_t length, i;
+    FILE *fptr;
+
+    if (key == NULL)
+        return e_stego_bad_args;
+    if (path == NULL)
+    {
+        hex = getenv("STEGO_KEY");
+        if (hex == NULL)
+            return e_stego_no_key;
+        length = strlen(hex);
+    }
+    else
+    {
+        fptr = fopen(path, "rb");
+        if (fptr == NULL)
+            return e_stego_io;
+        length = fread(text, 1, sizeof(text), fptr);
+        fclose(fptr);
+
+        // A raw key file is taken as it is
+        if (length == STEGO_KEY_SIZE)
+        {
+            memcpy(key, text, STEGO_KEY_SIZE);
+            memset(text, 0, sizeof(text));
+            return e_stego_ok;
+        }
+    }
+
+    // Otherwise hex digits, as an editor or `openssl rand -hex 32` leaves them
+    while (length > 0 && (hex[length - 1] == '\n' || hex[length - 1] == '\r'))
+        length--;
+    if (length != 2 * STEGO_KEY_SIZE)
+        return e_stego_bad_args;
+    for (i = 0; i < STEGO_KEY_SIZE; i++)
+    {
+        int hi = hex_digit(hex[2 * i]), lo = hex_digit(hex[2 * i + 1]);
+
+        if (hi < 0 || lo < 0)
+            return e_stego_bad_args;
+        key[i] = hi << 4 | lo;
+    }
+    memset(text, 0, sizeof(text));
+    return e_stego_ok;
+}
+
+// Payload bytes left in layout once the header fields and the checksum are in
+static long payload_room(const BmpLayout *layout, size_t extn_len, int bits)
+{
+    long room = layout->usable - (long)HEADER_BYTES(extn_len);
+
+    room = room > 0 ? room * bits / 8 - CRC_SIZE : 0;
+    return room > 0 ? room : 0;
+}
+
+long stego_capacity(const unsigned char *cover, size_t cover_size, size_t extn_len, int bits)
+{
+    BmpLayout layout;
+
+    if (bmp_parse(cover, cover_size, cover_size, &layout) == e_failure || lsb_kernel_bits(bits) == NULL)
+        return -1;
+    return payload_room(&layout, extn_len, bits);
+}
+
+StegoError stego_analyze_file(const char *path, StegoCoverInfo *info)
+{
+    unsigned char header[BMP_MAX_HEADER_SIZE];
+    struct stat st;
+    BmpLayout layout;
+    ssize_t size;
+    int fd, i;
+
+    if (path == NULL || info == NULL)
+        return e_stego_bad_args;
+
+    // One read of the headers and a stat: the pixels are never touched
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return e_stego_io;
+    size = pread(fd, header, sizeof(header), 0);
+    if (size < 0 || fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return e_stego_io;
+    }
+    close(fd);
+    if (bmp_parse(header, size, S_ISREG(st.st_mode) ? st.st_size : -1, &layout) == e_failure)
+        return e_stego_bad_image;
+
+    info->width = layout.width;
+    info->height = layout.height;
+    info->bpp = layout.bpp;
+    info->top_down = layout.top_down;
+    info->data_offset = layout.offset;
+    info->usable = layout.usable;
+    for (i = 0; i < 3; i++)
+        info->max_payload[i] = payload_room(&layout, STEGO_MAX_EXTN, 1 << i);
+    return e_stego_ok;
+}
+
+// Header fields straight from a file prefix: 1 bit per carrier byte, MSB first
+typedef struct
+{
+    const unsigned char *head;
+    const BmpLayout *layout;
+    long pos;
+} FieldReader;
+
+static Status read_field(FieldReader *reader, unsigned char *out, int size)
+{
+    int i, bit;
+
+    if (reader->pos + size * 8 > reader->layout->usable)
+        return e_failure;
+    for (i = 0; i < size; i++)
+    {
+        out[i] = 0;
+        for (bit = 0; bit < 8; bit++)
+            out[i] = out[i] << 1 | (reader->head[bmp_offset(reader->layout, reader->pos++)] & 1);
+    }
+    return e_success;
+}
+
+// Start over at carrier byte 0 of layout and check the magic string
+static Status read_magic_field(FieldReader *reader, const BmpLayout *layout)
+{
+    char magic[sizeof(MAGIC_STRING) - 1];
+
+    reader->layout = layout;
+    reader->pos = 0;
+    if (read_field(reader, (unsigned char *)magic, sizeof(magic)) == e_failure)
+        return e_failure;
+    return memcmp(magic, MAGIC_STRING, sizeof(magic)) == 0 ? e_success : e_failure;
+}
+
+static Status read_word_field(FieldReader *reader, uint *word)
+{
+    unsigned char bytes[4];
+
+    if (read_field(reader, bytes, 4) == e_failure)
+        return e_failure;
+    *word = (uint)bytes[0] << 24 | (uint)bytes[1] << 16 | (uint)bytes[2] << 8 | bytes[3];
+    return e_success;
+}
+
+StegoError stego_probe(const unsigned char *head, size_t head_size, long file_size, StegoProbe *probe,
+                       size_t *needed)
+{
+    BmpLayout layout, legacy;
+    FieldReader reader = {head, NULL, 0};
+    long end;
+    uint word, size;
+
+    if (head == NULL || probe == NULL || needed == NULL)
+        return e_stego_bad_args;
+    if (bmp_parse_stego(head, head_size, file_size, &layout) == e_failure)
+        return e_stego_bad_image;
+    bmp_legacy_layout(&layout, &legacy);
+
+    // Every field the decoder reads before the data, in either layout
+    end = bmp_offset(&layout, HEADER_BYTES(STEGO_MAX_EXTN));
+    if (end < BMP_LEGACY_OFFSET + (long)HEADER_BYTES(STEGO_MAX_EXTN))
+        end = BMP_LEGACY_OFFSET + HEADER_BYTES(STEGO_MAX_EXTN);
+    if (file_size >= 0 && end > file_size)
+        end = file_size;
+    if ((long)head_size < end)
+    {
+        *needed = end;
+        return e_stego_buffer_small;
+    }
+
+    // Same layout choices as decode_magic_string() and decode_secret_file_extn_size()
+    if (read_magic_field(&reader, &layout) == e_failure &&
+        (bmp_matches_legacy(&layout) || read_magic_field(&reader, &legacy) == e_failure))
+        return e_stego_not_stego;
+    if (read_word_field(&reader, &word) == e_failure)
+        return e_stego_corrupt;
+    if (!(word & FLAG_PIXEL_LAYOUT) && !bmp_matches_legacy(reader.layout))
+    {
+        if (read_magic_field(&reader, &legacy) == e_failure || read_word_field(&reader, &word) == e_failure)
+            return e_stego_corrupt;
+    }
+    if ((word & ~(EXTN_SIZE_MASK | KNOWN_HEADER_FLAGS)) || ((word & DENSITY_MASK) >> DENSITY_SHIFT) > 2 ||
+        (word & EXTN_SIZE_MASK) > STEGO_MAX_EXTN)
+        return e_stego_corrupt;
+
+    memset(probe->extn, 0, sizeof(probe->extn));
+    if (read_field(&reader, (unsigned char *)probe->extn, word & EXTN_SIZE_MASK) == e_failure ||
+        read_word_field(&reader, &size) == e_failure || (int)size < 0)
+        return e_stego_corrupt;
+    probe->streamed = (word & FLAG_STREAMED) != 0;
+    probe->size = probe->streamed ? -1 : (long)size;
+    probe->bits = 1 << ((word & DENSITY_MASK) >> DENSITY_SHIFT);
+    probe->compressed = (word & FLAG_COMPRESSED) != 0;
+    probe->crc = (word & FLAG_CRC) != 0;
+    probe->encrypted = (word & FLAG_ENCRYPTED) != 0;
+    probe->archive = (word & FLAG_ARCHIVE) != 0;
+    probe->scattered = (word & FLAG_SCATTERED) != 0;
+    probe->fec = (word & FLAG_FEC) != 0;
+    return e_stego_ok;
+}
+
+StegoError stego_encode_buffer(const unsigned char *cover, size_t cover_size,
+                               const unsigned char *payload, size_t payload_size,
+                               const char *extn, unsigned char *out, size_t out_size,
+                               const StegoOptions *options)
+{
+    EncodeInfo encInfo;
+    BmpLayout layout;
+
+    options = check_options(options);
+    if (options == NULL || out == NULL || out_size < cover_size || (payload == NULL && payload_size != 0) ||
+        extn == NULL || strlen(extn) > STEGO_MAX_EXTN)
+        return e_stego_bad_args;
+    if (bmp_parse(cover, cover_size, cover_size, &layout) == e_failure)
+        return e_stego_bad_image;
+
+    // Same stages as the file encoder, with both images in memory
+    memset(&encInfo, 0, sizeof(encInfo));
+    encInfo.src_image_fname = "cover buffer";
+    encInfo.secret_fname = "payload buffer";
+    encInfo.stego_image_fname = "output buffer";
+    encInfo.secret_data = (const char *)payload;
+    encInfo.size_secret_file = payload_size;
+    encInfo.threads = 1;
+    encInfo.bits = options->bits;
+    encInfo.compress = options->compress;
+    encInfo.crc = options->crc;
+    encInfo.key = options->key;
+    encInfo.scatter = options->scatter;
+    encInfo.fec = options->fec;
+    strcpy(encInfo.extn_secret_file, extn);
+
+    if (lsb_engine_init_mem(&encInfo.engine, cover, cover_size, out, &layout) == e_failure)
+        return e_stego_no_memory;
+    stage_clock_start(&encInfo.clock, options->stats);
+    encode_image(&encInfo);
+    stage_clock_stop(&encInfo.clock);
+    lsb_engine_free(&encInfo.engine);
+    return encInfo.error;
+}
+
+// fopencookie write hook: forward the decoder's output to the sink
+static ssize_t sink_write(void *cookie, const char *data, size_t size)
+{
+    SinkCookie *sc = cookie;
+
+    if (sc->sink(sc->user, data, size) != 0)
+    {
+        sc->failed = 1;
+        return -1;
+    }
+    return size;
+}
+
+StegoError stego_decode_to_sink(const unsigned char *stego, size_t stego_size,
+                                stego_sink_fn sink, void *user, char extn[STEGO_MAX_EXTN + 1],
+                                const StegoOptions *options)
+{
+    cookie_io_functions_t io = {NULL, sink_write, NULL, NULL};
+    SinkCookie cookie = {sink, user, 0};
+    DecodeInfo decInfo;
+    BmpLayout layout;
+
+    options = check_options(options);
+    if (options == NULL || stego == NULL || sink == NULL)
+        return e_stego_bad_args;
+    if (bmp_parse_stego(stego, stego_size, stego_size, &layout) == e_failure)
+        return e_stego_bad_image;
+
+    memset(&decInfo, 0, sizeof(decInfo));
+    decInfo.stego_image_fname = "stego buffer";
+    strcpy(decInfo.secret_fname, "sink");
+    decInfo.threads = 1;
+    decInfo.key = options->key;
+    decInfo.range_offset = options->range_offset;
+    decInfo.range_length = options->range_length;
+    decInfo.pipeline = options->pipeline;
+
+    // Whole payload blocks reach the sink: the stream adds no buffering of its own
+    decInfo.fptr_secret = fopencookie(&cookie, "w", io);
+    if (decInfo.fptr_secret == NULL)
+        return e_stego_no_memory;
+    setvbuf(decInfo.fptr_secret, NULL, _IONBF, 0);
+
+    if (lsb_engine_init_mem(&decInfo.engine, stego, stego_size, NULL, &layout) == e_failure)
+    {
+        decInfo.error = e_stego_no_memory;
+    }
+    else
+    {
+        stage_clock_start(&decInfo.clock, options->stats);
+        decode_image(&decInfo);
+        stage_clock_stop(&decInfo.clock);
+    }
+    lsb_engine_free(&decInfo.engine);
+    fclose(decInfo.fptr_secret);
+
+    if (cookie.failed)
+        return e_stego_sink_failed;
+    if (decInfo.error == e_stego_ok && extn != NULL)
+        strcpy(extn, decInfo.extn_secret_file);
+    return decInfo.error;
+}
+
+// Sink for stego_decode_buffer(): copy what fits, count the rest
+static int buffer_sink(void *user, const void *data, size_t size)
+{
+    BufferSink *bs = user;
+    size_t room = bs->total < bs->out_size ? bs->out_size - bs->total : 0;
+
+    if (room > 0)
+        memcpy(bs->out + bs->total, data, size < room ? size : room);
+    bs->total += size;
+    return 0;
+}
+
+StegoError stego_decode_buffer(const unsigned char *stego, size_t stego_size,
+                               unsigned char *out, size_t out_size, size_t *payload_size,
+                               char extn[STEGO_MAX_EXTN + 1], const StegoOptions *options)
+{
+    BufferSink bs = {out, out_size, 0};
+    StegoError err;
+
+    if (out == NULL && out_size != 0)
+        return e_stego_bad_args;
+
+    err = stego_decode_to_sink(stego, stego_size, buffer_sink, &bs, extn, options);
+    if (payload_size != NULL)
+        *payload_size = bs.total;
+    if (err == e_stego_ok && bs.total > out_size)
+        return e_stego_buffer_small;
+    return err;
+}
+
+StegoError stego_encode_file(const char *cover, const char *secret, const char *stego,
+                             const StegoOptions *options)
+{
+    char *argv[] = {"", "-e", (char *)cover, (char *)secret, (char *)stego, NULL};
+    EncodeInfo encInfo;
+
+    options = check_options(options);
+    if (options == NULL || cover == NULL || secret == NULL)
+        return e_stego_bad_args;
+
+    // Same validation as the command line
+    if (read_and_validate_encode_args(argv, &encInfo) == e_failure)
+        return e_stego_bad_args;
+    encInfo.threads = options->threads;
+    encInfo.bits = options->bits;
+    encInfo.compress = options->compress;
+    encInfo.crc = options->crc;
+    encInfo.key = options->key;
+    encInfo.scatter = options->scatter;
+    encInfo.fec = options->fec;
+    encInfo.pipeline = options->pipeline;
+
+    stage_clock_start(&encInfo.clock, options->stats);
+    do_encoding(&encInfo);
+    close_encode_files(&encInfo);
+    stage_clock_stop(&encInfo.clock);
+    return encInfo.error;
+}
+
+StegoError stego_encode_in_place(const char *image, const char *secret, const StegoOptions *options)
+{
+    char *argv[] = {"", "-e", (char *)image, (char *)secret, NULL};
+    EncodeInfo encInfo;
+
+    options = check_options(options);
+    if (options == NULL || image == NULL || secret == NULL || strcmp(image, STREAM_NAME) == 0)
+        return e_stego_bad_args;
+
+    if (read_and_validate_encode_args(argv, &encInfo) == e_failure)
+        return e_stego_bad_args;
+    encInfo.stego_image_fname = encInfo.src_image_fname;
+    encInfo.in_place = 1;
+    encInfo.bits = options->bits;
+    encInfo.compress = options->compress;
+    encInfo.crc = options->crc;
+    encInfo.key = options->key;
+    encInfo.scatter = options->scatter;
+    encInfo.fec = options->fec;
+
+    stage_clock_start(&encInfo.clock, options->stats);
+    do_encoding(&encInfo);
+    close_encode_files(&encInfo);
+    stage_clock_stop(&encInfo.clock);
+    return encInfo.error;
+}
+
+StegoError stego_decode_file(const char *stego, const char *output_name, const StegoOptions *options)
+{
+    char *argv[] = {"", "-d", (char *)stego, (char *)output_name, NULL};
+    DecodeInfo decInfo;
+
+    options = check_options(options);
+    if (options == NULL || stego == NULL)
+        return e_stego_bad_args;
+
+    if (read_and_validate_decode_args(argv, &decInfo) == e_failure)
+        return e_stego_bad_args;
+    decInfo.threads = options->threads;
+    decInfo.key = options->key;
+    decInfo.range_offset = options->range_offset;
+    decInfo.range_length = options->range_length;
+    decInfo.pipeline = options->pipeline;
+
+    stage_clock_start(&decInfo.clock, options->stats);
+    do_decoding(&decInfo);
+    close_decode_files(&decInfo);
+    stage_clock_stop(&decInfo.clock);
+    return decInfo.error;
+}
+
+StegoError stego_archive_file(const char *cover, char *const files[], int count, const char *stego,
+                              const StegoOptions *options)
+{
+    EncodeInfo encInfo;
+    Archive archive;
+
+    options = check_options(options);
+    if (options == NULL || cover == NULL || files == NULL || count < 1 || options->compress || options->key != NULL ||
+        options->fec)
+        return e_stego_bad_args;
+
+    // The single-file stages, with the archive standing in for the secret
+    memset(&encInfo, 0, sizeof(encInfo));
+    encInfo.src_image_fname = (char *)cover;
+    encInfo.secret_fname = "archive";
+    encInfo.stego_image_fname = stego != NULL ? (char *)stego : "stego.bmp";
+    encInfo.threads = 1;
+    encInfo.bits = options->bits;
+    encInfo.crc = options->crc;
+
+    stage_clock_start(&encInfo.clock, options->stats);
+    if (archive_prepare(&encInfo, &archive, files, count) == e_success)
+        do_encoding(&encInfo);
+    close_encode_files(&encInfo);
+    stage_clock_stop(&encInfo.clock);
+    archive_free(&archive);
+    return encInfo.error;
+}
+
+StegoError stego_list_file(const char *stego, stego_entry_fn fn, void *user)
+{
+    DecodeInfo decInfo;
+    Archive archive;
+    int i;
+
+    if (stego == NULL || fn == NULL)
+        return e_stego_bad_args;
+
+    memset(&decInfo, 0, sizeof(decInfo));
+    decInfo.stego_image_fname = (char *)stego;
+    decInfo.threads = 1;
+    stage_clock_start(&decInfo.clock, NULL);
+
+    if (archive_read_toc(&decInfo, &archive) == e_success)
+    {
+        for (i = 0; i < archive.count; i++)
+        {
+            if (fn(user, &archive.entries[i]) != 0)
+                break;
+        }
+    }
+    close_decode_files(&decInfo);
+    archive_free(&archive);
+    return decInfo.error;
+}
+
+StegoError stego_extract_file(const char *stego, const char *name, const char *output,
+                              const StegoOptions *options)
+{
+    DecodeInfo decInfo;
+    Archive archive;
+
+    options = check_options(options);
+    if (output == NULL)
+        output = name;
+    if (options == NULL || stego == NULL || name == NULL || strlen(output) >= MAX_SECRET_FNAME)
+        return e_stego_bad_args;
+
+    memset(&decInfo, 0, sizeof(decInfo));
+    decInfo.stego_image_fname = (char *)stego;
+    strcpy(decInfo.secret_fname, output);
+    decInfo.threads = options->threads;
+
+    stage_clock_start(&decInfo.clock, options->stats);
+    if (archive_read_toc(&decInfo, &archive) == e_success)
+        archive_extract(&decInfo, &archive, name);
+    close_decode_files(&decInfo);
+    stage_clock_stop(&decInfo.clock);
+    archive_free(&archive);
+    return decInfo.error;
+}
@@ -0,0 +1,209 @@
+#ifndef STEGO_H
+#define STEGO_H
+
+#include <stddef.h>
+
+/*
+ * libstego - public API
+ * Hides a payload in the LSBs of a 24 or 32 bpp BMP and gets it back, from
+ * files or from memory buffers. The library never prints; progress
+ * and failure messages only reach a callback set with stego_set_log().
+ */
+
+/* Longest extension recorded with a payload (".txt") */
+#define STEGO_MAX_EXTN 4
+
+/* File prefix that holds the headers and hidden fields of all but exotic BMPs */
+#define STEGO_PROBE_SIZE 4096
+
+/* ChaCha20-Poly1305 key length */
+#define STEGO_KEY_SIZE 32
+
+/* Longest file name an archive records */
+#define STEGO_MAX_NAME 255
+
+typedef enum
+{
+    e_stego_ok,
+    e_stego_bad_args,     /* NULL buffer, bad extension or file name */
+    e_stego_bad_image,    /* Cover is not a BMP we can use */
+    e_stego_no_capacity,  /* Payload does not fit into the cover */
+    e_stego_not_stego,    /* Magic string missing: nothing hidden here */
+    e_stego_corrupt,      /* Header fields out of range or checksum mismatch */
+    e_stego_buffer_small, /* Output buffer too small, see *needed / *payload_size */
+    e_stego_sink_failed,  /* Sink callback asked to stop */
+    e_stego_io,           /* Read/write/open failure */
+    e_stego_no_memory,
+    e_stego_no_key,      /* Payload is encrypted and no key was given */
+    e_stego_auth_failed, /* Wrong key, or the encrypted payload was altered */
+    e_stego_is_archive,  /* Payload is an archive: list or extract its files */
+    e_stego_not_archive, /* Payload is a single file */
+    e_stego_no_entry     /* No file of that name in the archive */
+} StegoError;
+
+/* Stages of an encode or decode, in the order they run */
+typedef enum
+{
+    e_stage_open,      /* Opening files, reading the BMP headers */
+    e_stage_check,     /* Capacity check (encode) */
+    e_stage_header,    /* Copying the BMP headers (encode) */
+    e_stage_magic,
+    e_stage_extn_size,
+    e_stage_extn,
+    e_stage_size,
+    e_stage_data,
+    e_stage_crc,
+    e_stage_remainder, /* Copying the carrier after the payload (encode) */
+    STEGO_STAGE_COUNT
+} StegoStage;
+
+/* Where one encode or decode spent its time; the I/O counters are the
+ * process's read/write family syscalls during each stage (Linux only) */
+typedef struct
+{
+    double seconds[STEGO_STAGE_COUNT];  /* Wall time per stage */
+    long read_bytes[STEGO_STAGE_COUNT]; /* Mapped carrier bytes are not read by syscalls */
+    long write_bytes[STEGO_STAGE_COUNT];
+    long read_calls[STEGO_STAGE_COUNT];
+    long write_calls[STEGO_STAGE_COUNT];
+    int io_counted;                     /* 0: /proc/self/io was not readable, counters are 0 */
+    double total;                       /* Wall time of the whole call */
+} StegoStats;
+
+/* Tuning for the encode/decode calls; a NULL pointer means the defaults */
+typedef struct
+{
+    int threads;  /* Worker threads for the data stage, file API only (default 1) */
+    int bits;     /* Payload bits per carrier byte when encoding: 1, 2 or 4 (default 1) */
+    int compress; /* LZ compress the payload when encoding, if it shrinks (default 0) */
+    int crc;      /* Append a CRC32C that decoding verifies (default 1) */
+    const unsigned char *key; /* STEGO_KEY_SIZE bytes: encrypt when encoding, open encrypted
+                                 payloads when decoding (default NULL) */
+    StegoStats *stats; /* Filled with per-stage timings when not NULL (default NULL) */
+    long range_offset; /* Decode only payload bytes [range_offset, range_offset + range_length); */
+    long range_length; /* 0 runs to the end. The checksum is not verified for a range (default 0, 0) */
+    int pipeline; /* With one thread, read, embed/extract and write the data on three overlapping
+                     threads, file API and decoding (default 1) */
+    int scatter;  /* Encoding with a key: spread the data over the whole image in blocks ordered
+                     by the key instead of right after the header (default 0) */
+    int fec;      /* Encoding: code the data and checksum in Reed-Solomon stripes that put up to
+                     16 damaged bytes in 255 right when decoding; not for archives (default 0) */
+} StegoOptions;
+
+/* What a cover offers, from its headers alone */
+typedef struct
+{
+    long width;
+    long height;
+    int bpp;               /* 24 or 32 */
+    int top_down;          /* Rows stored top row first */
+    long data_offset;      /* bfOffBits */
+    long usable;           /* Carrier bytes: B, G and R of every pixel */
+    long max_payload[3];   /* Largest plain payload at 1, 2 and 4 bits per byte, for a
+                              STEGO_MAX_EXTN extension and with the checksum */
+} StegoCoverInfo;
+
+/* What the hidden header fields of a stego image say */
+typedef struct
+{
+    long size;                       /* Payload bytes (before compression), -1 when streamed */
+    char extn[STEGO_MAX_EXTN + 1];
+    int bits;                        /* Payload bits per carrier byte */
+    int compressed;
+    int crc;
+    int encrypted;
+    int archive;                     /* Payload is an archive of files */
+    int streamed;                    /* Encoded from a stream: the size is known once decoded */
+    int scattered;                   /* Data in the key's block order: only the key finds it */
+    int fec;                         /* Data coded in Reed-Solomon stripes */
+} StegoProbe;
+
+/* One file of an archive, as its table of contents records it */
+typedef struct
+{
+    char name[STEGO_MAX_NAME + 1];
+    long offset;       /* Data bytes before the file */
+    long size;
+    unsigned int crc;  /* CRC32C of the file */
+} StegoEntry;
+
+/* Receives decoded payload in order; return non-zero to abort the decode */
+typedef int (*stego_sink_fn)(void *user, const void *data, size_t size);
+
+/* Receives archive entries in table of contents order; return non-zero to stop listing */
+typedef int (*stego_entry_fn)(void *user, const StegoEntry *entry);
+
+/* Receives every status line; is_error is 1 for failures */
+typedef void (*stego_log_fn)(void *user, int is_error, const char *message);
+
+/* Route status lines to fn (NULL: stay silent, the default) */
+void stego_set_log(stego_log_fn fn, void *user);
+
+/* Text for an error code */
+const char *stego_strerror(StegoError err);
+
+/* Short name of a stage ("magic", "data", ...) */
+const char *stego_stage_name(StegoStage stage);
+
+/* Fill options with the defaults */
+void stego_options_init(StegoOptions *options);
+
+/* Read a key from path (32 raw bytes or 64 hex digits), or from $STEGO_KEY (hex) when path is NULL */
+StegoError stego_load_key(const char *path, unsigned char key[STEGO_KEY_SIZE]);
+
+/* Largest payload that fits into cover with an extension of extn_len chars at bits per byte,
+ * leaving room for the checksum; -1 if not a BMP */
+long stego_capacity(const unsigned char *cover, size_t cover_size, size_t extn_len, int bits);
+
+/* Read only the headers of the BMP at path; e_stego_bad_image when it is not one we can use */
+StegoError stego_analyze_file(const char *path, StegoCoverInfo *info);
+
+/* Read the hidden fields from the first head_size bytes of a BMP of file_size bytes;
+ * e_stego_not_stego when nothing is hidden, e_stego_buffer_small (*needed: prefix to
+ * read) when the fields lie beyond head_size */
+StegoError stego_probe(const unsigned char *head, size_t head_size, long file_size, StegoProbe *probe,
+                       size_t *needed);
+
+/* Encode payload into a copy of cover; out must hold cover_size bytes */
+StegoError stego_encode_buffer(const unsigned char *cover, size_t cover_size,
+                               const unsigned char *payload, size_t payload_size,
+                               const char *extn, unsigned char *out, size_t out_size,
+                               const StegoOptions *options);
+
+/* Decode into out; *payload_size gets the payload length (also when out is too small) */
+StegoError stego_decode_buffer(const unsigned char *stego, size_t stego_size,
+                               unsigned char *out, size_t out_size, size_t *payload_size,
+                               char extn[STEGO_MAX_EXTN + 1], const StegoOptions *options);
+
+/* Decode through sink in blocks; extn may be NULL */
+StegoError stego_decode_to_sink(const unsigned char *stego, size_t stego_size,
+                                stego_sink_fn sink, void *user, char extn[STEGO_MAX_EXTN + 1],
+                                const StegoOptions *options);
+
+/* File-to-file encode; stego may be NULL for "stego.bmp". "-" reads cover or secret from stdin
+ * (not both) or writes stego to stdout, front to back; a secret from stdin has no extension */
+StegoError stego_encode_file(const char *cover, const char *secret, const char *stego,
+                             const StegoOptions *options);
+
+/* Encode secret into image itself: only the carrier bytes whose LSBs change are written, with
+ * pwrite, and the rest of the file is left alone. A failure partway leaves image half written */
+StegoError stego_encode_in_place(const char *image, const char *secret, const StegoOptions *options);
+
+/* File-to-file decode; output_name is extended with the hidden extension (NULL: "secret_file").
+ * "-" reads stego from stdin or writes the payload to stdout, unextended */
+StegoError stego_decode_file(const char *stego, const char *output_name, const StegoOptions *options);
+
+/* Embed count files, recorded under their base names, behind a table of contents; stego may be
+ * NULL for "stego.bmp". Archives are neither compressed nor encrypted: e_stego_bad_args if asked */
+StegoError stego_archive_file(const char *cover, char *const files[], int count, const char *stego,
+                              const StegoOptions *options);
+
+/* Hand every entry of the archive in stego to fn, decoding only the table of contents */
+StegoError stego_list_file(const char *stego, stego_entry_fn fn, void *user);
+
+/* Write the archive entry called name to output (NULL: name, in the current directory;
+ * "-": stdout), decoding only that entry's carrier bytes */
+StegoError stego_extract_file(const char *stego, const char *name, const char *output,
+                              const StegoOptions *options);
+
+#endif
@@ -0,0 +1,83 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - per-thread status output
+*/
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "stego_log.h"
+#include "stego.h"
+
+static stego_log_fn log_fn;
+static void *log_user;
+static __thread int quiet;
+static __thread char first_error[MAX_ERROR_MSG];
+
+// Install the status line callback for the whole process
+void stego_set_log(stego_log_fn fn, void *user)
+{
+    log_fn = fn;
+    log_user = user;
+}
+
+// Format one line and hand it to the callback
+static void emit(int is_error, const char *fmt, va_list ap)
+{
+    char line[MAX_LOG_LINE];
+
+    vsnprintf(line, sizeof(line), fmt, ap);
+    log_fn(log_user, is_error, line);
+}
+
+// Progress chatter, only when someone listens and this thread is not quiet
+void stego_info(const char *fmt, ...)
+{
+    va_list ap;
+
+    if (quiet || log_fn == NULL)
+        return;
+    va_start(ap, fmt);
+    emit(0, fmt, ap);
+    va_end(ap);
+}
+
+// Report a failure and keep the first one as the job's reason
+void stego_error(const char *fmt, ...)
+{
+    va_list ap;
+    size_t len;
+
+    if (first_error[0] == '\0')
+    {
+        va_start(ap, fmt);
+        vsnprintf(first_error, sizeof(first_error), fmt, ap);
+        va_end(ap);
+
+        // One line in batch reports: drop the trailing newline
+        len = strlen(first_error);
+        while (len > 0 && first_error[len - 1] == '\n')
+            first_error[--len] = '\0';
+    }
+
+    if (quiet || log_fn == NULL)
+        return;
+    va_start(ap, fmt);
+    emit(1, fmt, ap);
+    va_end(ap);
+}
+
+void stego_set_quiet(int value)
+{
+    quiet = value;
+}
+
+const char *stego_first_error(void)
+{
+    return first_error;
+}
+
+void stego_reset_error(void)
+{
+    first_error[0] = '\0';
+}
@@ -0,0 +1,30 @@
+#ifndef STEGO_LOG_H
+#define STEGO_LOG_H
+
+/*
+ * Status output of the encode/decode stages
+ * Lines go to the callback installed with stego_set_log() (none by
+ * default, so the library stays silent). A thread can also silence
+ * itself, e.g. a batch worker, and still collect the first failure
+ * message of each job.
+ */
+
+#define MAX_ERROR_MSG 256
+#define MAX_LOG_LINE 1024
+
+/* Progress chatter, dropped when quiet */
+void stego_info(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/* Failure message, remembered for stego_first_error() */
+void stego_error(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/* Silence (1) or restore (0) output on the calling thread */
+void stego_set_quiet(int quiet);
+
+/* First failure since stego_reset_error() on this thread, "" if none */
+const char *stego_first_error(void);
+
+/* Forget the recorded failure before starting a new job */
+void stego_reset_error(void);
+
+#endif
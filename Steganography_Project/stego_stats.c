@@ -0,0 +1,109 @@
+/*  Documentation
+Name        : G.V.Pavan Kumar
+Date        : 17-10-2026
+Description : Steganography - per-stage timing
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "stego_stats.h"
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// One pread of the kept-open /proc/self/io; the read itself shows up in the next sample
+static int sample_io(StageClock *clock, IoSample *sample)
+{
+    char text[512], *line;
+    ssize_t n;
+
+    n = pread(clock->io_fd, text, sizeof(text) - 1, 0);
+    if (n <= 0)
+        return -1;
+    text[n] = '\0';
+    memset(sample, 0, sizeof(*sample));
+    for (line = text; line != NULL; line = strchr(line, '\n'), line = line ? line + 1 : NULL)
+    {
+        if (strncmp(line, "rchar:", 6) == 0)
+            sample->rchar = atol(line + 6);
+        else if (strncmp(line, "wchar:", 6) == 0)
+            sample->wchar = atol(line + 6);
+        else if (strncmp(line, "syscr:", 6) == 0)
+            sample->syscr = atol(line + 6);
+        else if (strncmp(line, "syscw:", 6) == 0)
+            sample->syscw = atol(line + 6);
+    }
+    clock->io_read = n;
+    return 0;
+}
+
+// Charge the running stage with the time and I/O since it began
+static void charge(StageClock *clock)
+{
+    StegoStats *stats = clock->stats;
+    double now = now_seconds();
+    long own = clock->io_read;
+    IoSample io;
+
+    stats->seconds[clock->stage] += now - clock->started;
+    clock->started = now;
+    if (clock->io_fd < 0 || sample_io(clock, &io) != 0)
+        return;
+
+    // Minus the previous sample's own read of /proc/self/io
+    stats->read_bytes[clock->stage] += io.rchar - clock->io.rchar - own;
+    stats->write_bytes[clock->stage] += io.wchar - clock->io.wchar;
+    stats->read_calls[clock->stage] += io.syscr - clock->io.syscr - 1;
+    stats->write_calls[clock->stage] += io.syscw - clock->io.syscw;
+    clock->io = io;
+}
+
+void stage_clock_start(StageClock *clock, StegoStats *stats)
+{
+    clock->stats = stats;
+    clock->stage = -1;
+    clock->io_fd = -1;
+    if (stats == NULL)
+        return;
+    memset(stats, 0, sizeof(*stats));
+
+    clock->io_fd = open("/proc/self/io", O_RDONLY | O_CLOEXEC);
+    if (clock->io_fd >= 0 && sample_io(clock, &clock->io) != 0)
+    {
+        close(clock->io_fd);
+        clock->io_fd = -1;
+    }
+    stats->io_counted = clock->io_fd >= 0;
+    clock->first = clock->started = now_seconds();
+    clock->stage = e_stage_open;
+}
+
+void stage_enter(StageClock *clock, StegoStage stage)
+{
+    if (clock->stats == NULL)
+        return;
+    if (clock->stage >= 0)
+        charge(clock);
+    else
+        clock->started = now_seconds();
+    clock->stage = stage;
+}
+
+void stage_clock_stop(StageClock *clock)
+{
+    if (clock->stats == NULL || clock->stage < 0)
+        return;
+    charge(clock);
+    clock->stats->total = clock->started - clock->first;
+    clock->stage = -1;
+    if (clock->io_fd >= 0)
+        close(clock->io_fd);
+    clock->io_fd = -1;
+}
@@ -0,0 +1,42 @@
+#ifndef STEGO_STATS_H
+#define STEGO_STATS_H
+
+#include "stego.h"
+
+/*
+ * Per-stage wall time and I/O of one encode or decode
+ * The stages call stage_enter() as they start; the time and the
+ * /proc/self/io counters since the last call go to the stage that was
+ * running. Everything is a no-op when no StegoStats was asked for.
+ */
+
+/* Cumulative read/write syscall counters of the process */
+typedef struct
+{
+    long rchar;
+    long wchar;
+    long syscr;
+    long syscw;
+} IoSample;
+
+typedef struct
+{
+    StegoStats *stats; /* NULL: not timing */
+    int stage;         /* Running stage, -1 when stopped */
+    double started;    /* When it began, seconds */
+    double first;      /* When the clock was started */
+    int io_fd;         /* /proc/self/io, -1 when not counting */
+    IoSample io;       /* Counters when the running stage began */
+    long io_read;      /* Bytes the last sample read itself */
+} StageClock;
+
+/* Zero stats and start timing e_stage_open */
+void stage_clock_start(StageClock *clock, StegoStats *stats);
+
+/* Charge the running stage and start stage (stages may be entered again) */
+void stage_enter(StageClock *clock, StegoStage stage);
+
+/* Charge the running stage and fill in the total */
+void stage_clock_stop(StageClock *clock);
+
+#endif
@@ -15,6 +15,13 @@ typedef enum
 {
     e_encode,
     e_decode,
+    e_batch,
+    e_analyze,
+    e_scan,
+    e_archive,
+    e_list,
+    e_extract,
+    e_daemon,
     e_unsupported
 } OperationType;
 